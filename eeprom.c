@@ -0,0 +1,77 @@
+#include "eeprom.h"
+
+#include <inc/tm4c123gh6pm.h>
+
+// each block is 16 words, the offset register only wraps inside a block
+#define EE_BLOCK_WORDS 16
+
+static char ee_ready = 0;
+
+// waits for the eeprom to finish whatever it's doing
+static void ee_wait_done() {
+    while (EEPROM_EEDONE_R & EEPROM_EEDONE_WORKING) /* noop */ ;
+}
+
+// a few clocks after enabling or resetting the module before it can be touched
+static void ee_settle() {
+    volatile int i;
+    for (i = 0; i < 6; i++) /* noop */ ;
+}
+
+int ee_init() {
+    SYSCTL_RCGCEEPROM_R |= 0x1;
+    ee_settle();
+    while (!(SYSCTL_PREEPROM_R & 0x1)) /* noop */ ;
+
+    // a write interrupted by a power loss is finished or rolled back here
+    ee_wait_done();
+    if (EEPROM_EESUPP_R & (EEPROM_EESUPP_PRETRY | EEPROM_EESUPP_ERETRY)) return -1;
+
+    // reset the module so it picks the recovered state up
+    SYSCTL_SREEPROM_R |= 0x1;
+    ee_settle();
+    SYSCTL_SREEPROM_R &= ~0x1;
+    ee_settle();
+    while (!(SYSCTL_PREEPROM_R & 0x1)) /* noop */ ;
+
+    ee_wait_done();
+    if (EEPROM_EESUPP_R & (EEPROM_EESUPP_PRETRY | EEPROM_EESUPP_ERETRY)) return -1;
+
+    ee_ready = 1;
+    return 0;
+}
+
+void ee_read(uint32_t address, uint32_t * data, int word_c) {
+    if (!ee_ready) return;
+
+    int i;
+    for (i = 0; i < word_c && address + i < EE_WORD_COUNT; i++) {
+        const uint32_t a = address + i;
+        EEPROM_EEBLOCK_R = a / EE_BLOCK_WORDS;
+        EEPROM_EEOFFSET_R = a % EE_BLOCK_WORDS;
+        data[i] = EEPROM_EERDWR_R;
+    }
+}
+
+int ee_write(uint32_t address, const uint32_t * data, int word_c) {
+    if (!ee_ready) return -1;
+    if (address + word_c > EE_WORD_COUNT) return -1;
+
+    int i;
+    for (i = 0; i < word_c; i++) {
+        const uint32_t a = address + i;
+        EEPROM_EEBLOCK_R = a / EE_BLOCK_WORDS;
+        EEPROM_EEOFFSET_R = a % EE_BLOCK_WORDS;
+
+        // writes wear the eeprom, leave what's already right alone
+        if (EEPROM_EERDWR_R == data[i]) continue;
+
+        EEPROM_EERDWR_R = data[i];
+        ee_wait_done();
+
+        if (EEPROM_EEDONE_R & EEPROM_EEDONE_NOPERM) return -1;
+        if (EEPROM_EESUPP_R & (EEPROM_EESUPP_PRETRY | EEPROM_EESUPP_ERETRY)) return -1;
+    }
+
+    return 0;
+}
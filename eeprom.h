@@ -0,0 +1,16 @@
+#pragma once
+
+#include <stdint.h>
+
+// the on-chip eeprom, 2KB as 512 32 bit words. addresses are in words
+#define EE_WORD_COUNT 512
+
+// init the eeprom, returns 0 if it's usable. call once at start
+int ee_init();
+
+// reads word_c words starting at word address into data
+void ee_read(uint32_t address, uint32_t * data, int word_c);
+
+// writes word_c words starting at word address, skipping any that already match. blocking, ~a few ms per changed word
+// returns 0 on success
+int ee_write(uint32_t address, const uint32_t * data, int word_c);
@@ -1,123 +1,299 @@
-#include "ir.h"
-#include "timer.h"
-#include <math.h>
-
-#include <inc/tm4c123gh6pm.h>
-
-
-// init the ir scanner
-void ir_init_fuck() {
-    // Enable clocks
-    SYSCTL_RCGCGPIO_R |= 0x2;   // Port B
-    SYSCTL_RCGCADC_R |= 0x1;    // ADC0
-    timer_waitMillis(1);
-
-    // Configure PB4 for analog function (AIN10)
-    GPIO_PORTB_DIR_R   &= ~0x10; // PB4 input
-    GPIO_PORTB_AFSEL_R |=  0x10; // PB4 uses alternate function (ADC)
-    GPIO_PORTB_DEN_R   &= ~0x10; // disable digital on PB4
-    GPIO_PORTB_AMSEL_R |=  0x10; // enable analog mode on PB4
-
-
-    // Hardware averaging
-    // SAC: 0=none, 1=2x, 2=4x, 3=8x, 4=16x, 5=32x, 6=64x
-    ADC0_SAC_R = 0x04;                // 16x average
-
-    // Disable SS0 while configuring
-    ADC0_ACTSS_R &= ~0x1;
-
-    // Trigger source: continuous (0xF)
-    ADC0_EMUX_R = (ADC0_EMUX_R | 0x000F);
-
-    // Multiplexer: SS0 sample 0 reads AIN10 (PB4)
-    // Each slot is 4 bits in SSMUX0
-    ADC0_SSMUX0_R = (ADC0_SSMUX0_R & ~0x000F) | 0xA;  // MUX0 = 10 (AIN10)
-
-    // Sample control: mark end of sequence
-    ADC0_SSCTL0_R = 0b0110;
-
-    // Clear any prior interrupts and unmask if you want to use NVIC
-    ADC0_ISC_R  = 0x01;       // clear SS0 flag
-    ADC0_IM_R  &= ~(1U << 0); // mask SS0 interrupt
-
-    // Re-enable SS0
-    ADC0_ACTSS_R |= 0x1;
-}
-
-// read a current ir sample
-int ir_read_sample_fuck() {
-    return ADC0_SSFIFO0_R & 0x0FFF;
-}
-
-// reads 16 ir values and returns the lowest
-int ir_floor_sample() {
-    int min_value = ir_read_sample_fuck();
-
-    int i;
-    for (i = 1; i < 8; i++) {
-        timer_waitMillis(2);
-        int new_value = ir_read_sample_fuck();
-        if (new_value < min_value) min_value = new_value;
-    }
-
-    return min_value;
-}
-
-float a = 0;
-float b = 0;
-
-void ir_set_a_b(float v_a, float v_b) {
-    a = v_a;
-    b = v_b;
-}
-
-float ir_raw_to_cm(int ir_raw_sample) {
-    return a/ir_raw_sample + b;
-}
-
-
-
-
-
-
-// automatic calibration
-float sum_n;  // num points
-float sum_t;  // (1/ir)
-float sum_y;  // (dist)
-float sum_t2; // (1/ir)^2
-float sum_ty; // (1/ir)*dist
-
-void ir_auto_cal_init() {
-    sum_n = 0;
-    sum_t = 0;
-    sum_y = 0;
-    sum_t2 = 0;
-    sum_ty = 0;
-}
-
-void ir_auto_cal_add_point(float ir_value, float distance) {
-    if (ir_value == 0) return;
-
-    float t = 1.0f / ir_value;
-    float y = distance;
-
-    sum_n++;
-    sum_t += t;
-    sum_y += y;
-    sum_t2 += t*t;
-    sum_ty += t*y;
-}
-
-Curve ir_auto_cal_calculate() {
-    double denom = sum_n * sum_t2 - sum_t * sum_t;
-    if (denom == 0) return (Curve) {0, 0};
-
-    double a_hat = (sum_n * sum_ty - sum_t * sum_y) / denom;
-    double b_hat = (sum_y - a_hat * sum_t) / sum_n;
-
-    return (Curve) {a_hat, b_hat};
-}
-
-
-
-
+#include "ir.h"
+#include "timer.h"
+#include <math.h>
+
+#include <inc/tm4c123gh6pm.h>
+
+
+// burst sampling. timer 2a triggers one hardware averaged conversion on ADC0 SS0 every IR_BURST_PERIOD_US,
+// the SS0 interrupt drains the fifo into the burst buffer and stops the timer once the burst is full
+#define IR_BURST_PERIOD_US 500
+#define IR_BURST_PERIOD_TICKS (IR_BURST_PERIOD_US * 16) // 16 MHz
+
+volatile int ir_burst_buffer[IR_BURST_SIZE];
+volatile int ir_burst_count = 0;
+volatile char ir_burst_done = 1;
+
+// the interrupt handler for ADC0 SS0
+void ir_adc_interrupt_handle() {
+    // clear the interrupt
+    ADC0_ISC_R = 0x01;
+
+    // drain the fifo (bit 8 of SSFSTAT0 is fifo empty)
+    while (!(ADC0_SSFSTAT0_R & 0x100)) {
+        int value = ADC0_SSFIFO0_R & 0x0FFF;
+        if (ir_burst_count < IR_BURST_SIZE) ir_burst_buffer[ir_burst_count++] = value;
+    }
+
+    // burst full, stop triggering
+    if (ir_burst_count >= IR_BURST_SIZE) {
+        TIMER2_CTL_R &= ~0x01;
+        ir_burst_done = 1;
+    }
+}
+
+// init the ir scanner
+void ir_init_fuck() {
+    // Enable clocks
+    SYSCTL_RCGCGPIO_R |= 0x2;   // Port B
+    SYSCTL_RCGCADC_R |= 0x1;    // ADC0
+    SYSCTL_RCGCTIMER_R |= 0x4;  // timer 2, the adc trigger
+    timer_waitMillis(1);
+
+    // Configure PB4 for analog function (AIN10)
+    GPIO_PORTB_DIR_R   &= ~0x10; // PB4 input
+    GPIO_PORTB_AFSEL_R |=  0x10; // PB4 uses alternate function (ADC)
+    GPIO_PORTB_DEN_R   &= ~0x10; // disable digital on PB4
+    GPIO_PORTB_AMSEL_R |=  0x10; // enable analog mode on PB4
+
+
+    // Hardware averaging
+    // SAC: 0=none, 1=2x, 2=4x, 3=8x, 4=16x, 5=32x, 6=64x
+    ADC0_SAC_R = 0x04;                // 16x average
+
+    // Disable SS0 while configuring
+    ADC0_ACTSS_R &= ~0x1;
+
+    // Trigger source: timer (0x5)
+    ADC0_EMUX_R = (ADC0_EMUX_R & ~0x000F) | 0x0005;
+
+    // Multiplexer: SS0 sample 0 reads AIN10 (PB4)
+    // Each slot is 4 bits in SSMUX0
+    ADC0_SSMUX0_R = (ADC0_SSMUX0_R & ~0x000F) | 0xA;  // MUX0 = 10 (AIN10)
+
+    // Sample control: mark end of sequence and interrupt on it
+    ADC0_SSCTL0_R = 0b0110;
+
+    // Clear any prior interrupts and unmask SS0
+    ADC0_ISC_R  = 0x01;      // clear SS0 flag
+    ADC0_IM_R  |= (1U << 0); // unmask SS0 interrupt
+    NVIC_EN0_R |= 1 << 14;   // enable ADC0 SS0 (interrupt number 14)
+    IntRegister(INT_ADC0SS0, ir_adc_interrupt_handle);
+
+    // Re-enable SS0
+    ADC0_ACTSS_R |= 0x1;
+
+
+    // timer 2a, periodic 16 bit, used only as the adc trigger
+    TIMER2_CTL_R &= ~0x01;                   // disable timer 2a
+    TIMER2_CFG_R  = 0x4;                     // split 16 bit mode
+    TIMER2_TAMR_R = 0x2;                     // periodic, count down
+    TIMER2_TAILR_R = IR_BURST_PERIOD_TICKS - 1;
+    TIMER2_CTL_R |= 0x20;                    // TAOTE - timeout triggers the adc
+}
+
+// starts a burst in the background
+void ir_burst_start() {
+    ir_burst_done = 0;
+    ir_burst_count = 0;
+
+    // throw away anything left over in the fifo
+    while (!(ADC0_SSFSTAT0_R & 0x100)) (void) ADC0_SSFIFO0_R;
+
+    TIMER2_TAV_R = 0;       // trigger right away
+    TIMER2_CTL_R |= 0x01;   // start timer 2a
+}
+
+char ir_burst_ready() {
+    return ir_burst_done;
+}
+
+// reduce a burst to one value
+int ir_burst_reduce(char mode) {
+    int sorted[IR_BURST_SIZE];
+    const int n = ir_burst_count;
+    if (n == 0) return 0;
+
+    // insertion sort, the burst is tiny
+    int i, j;
+    for (i = 0; i < n; i++) {
+        const int v = ir_burst_buffer[i];
+        for (j = i; j > 0 && sorted[j - 1] > v; j--) sorted[j] = sorted[j - 1];
+        sorted[j] = v;
+    }
+
+    if (mode == IR_REDUCE_MEDIAN) return sorted[n / 2];
+
+    if (mode == IR_REDUCE_TRIMMED_MEAN) {
+        // drop the lowest and highest quarter
+        const int trim = n / 4;
+        int sum = 0;
+        for (i = trim; i < n - trim; i++) sum += sorted[i];
+        return sum / (n - 2 * trim);
+    }
+
+    return sorted[0]; // IR_REDUCE_MIN
+}
+
+// read a current ir sample, the latest value of the last burst
+int ir_read_sample_fuck() {
+    if (ir_burst_count == 0) return 0;
+    return ir_burst_buffer[ir_burst_count - 1];
+}
+
+// blocking burst and reduce
+int ir_sample(char mode) {
+    ir_burst_start();
+    while (!ir_burst_ready()) /* noop */ ;
+    return ir_burst_reduce(mode);
+}
+
+// reads a burst of ir values and returns the lowest
+int ir_floor_sample() {
+    return ir_sample(IR_REDUCE_MIN);
+}
+
+// the calibrated curve. ir_raw_to_cm never evaluates it, it reads the lookup table built from it
+char model = IR_MODEL_HYPERBOLIC;
+float a = 0;
+float b = 0;
+
+// distance in cm (fixed point, IR_LUT_FRAC_BITS) at every 16th raw value, including 4096 so the last step can interpolate
+unsigned short ir_lut[IR_LUT_SIZE];
+
+// evaluates the curve, only used to build the table
+static float ir_model_eval(float x) {
+    if (x <= 0) return IR_LUT_MAX_CM;
+    if (model == IR_MODEL_POWER) return a * powf(x, b);
+    return a / x + b; // IR_MODEL_HYPERBOLIC
+}
+
+static void ir_lut_build() {
+    int i;
+    for (i = 0; i < IR_LUT_SIZE; i++) {
+        float cm = ir_model_eval(i << IR_LUT_SHIFT);
+        if (cm < 0) cm = 0;
+        if (cm > IR_LUT_MAX_CM) cm = IR_LUT_MAX_CM;
+        ir_lut[i] = (unsigned short) (cm * (1 << IR_LUT_FRAC_BITS) + 0.5f);
+    }
+}
+
+void ir_set_model(char v_model, float v_a, float v_b) {
+    model = v_model;
+    a = v_a;
+    b = v_b;
+    ir_lut_build();
+}
+
+Curve ir_get_model() {
+    return (Curve) {a, b, model};
+}
+
+void ir_set_a_b(float v_a, float v_b) {
+    ir_set_model(IR_MODEL_HYPERBOLIC, v_a, v_b);
+}
+
+// table lookup with linear interpolation between the entries, no divide
+unsigned short ir_raw_to_cm_fixed(int ir_raw_sample) {
+    if (ir_raw_sample < 0) ir_raw_sample = 0;
+    if (ir_raw_sample > 4095) ir_raw_sample = 4095;
+
+    const int i = ir_raw_sample >> IR_LUT_SHIFT;
+    const int frac = ir_raw_sample & ((1 << IR_LUT_SHIFT) - 1);
+    const int lo = ir_lut[i];
+    const int hi = ir_lut[i + 1];
+    return lo + (((hi - lo) * frac) >> IR_LUT_SHIFT);
+}
+
+float ir_raw_to_cm(int ir_raw_sample) {
+    return ir_raw_to_cm_fixed(ir_raw_sample) * (1.0f / (1 << IR_LUT_FRAC_BITS));
+}
+
+// noise on a raw sample after the hardware averaging and burst reduction, in adc counts
+#define IR_RAW_SIGMA 8.0f
+
+// noise is the raw noise times the slope of the curve at that distance
+float ir_cm_sigma(float cm) {
+    if (a == 0) return 0;
+
+    if (model == IR_MODEL_POWER) {
+        // for d = a*x^b, |dd/dx| = |b| * d / x, x = (d/a)^(1/b)
+        if (b == 0 || cm <= 0 || cm / a <= 0) return 0;
+        const float x = powf(cm / a, 1.0f / b);
+        return IR_RAW_SIGMA * fabsf(b) * cm / x;
+    }
+
+    // for d = a/x + b, |dd/dx| = a/x^2 = (d - b)^2 / a
+    return IR_RAW_SIGMA * (cm - b) * (cm - b) / fabsf(a);
+}
+
+
+
+
+
+
+// automatic calibration
+float sum_n;  // num points
+float sum_t;  // (1/ir)
+float sum_y;  // (dist)
+float sum_t2; // (1/ir)^2
+float sum_ty; // (1/ir)*dist
+float sum_u;  // ln(ir), for the power law fit
+float sum_v;  // ln(dist)
+float sum_u2; // ln(ir)^2
+float sum_uv; // ln(ir)*ln(dist)
+float sum_log_n; // points usable in log space
+
+void ir_auto_cal_init() {
+    sum_n = 0;
+    sum_t = 0;
+    sum_y = 0;
+    sum_t2 = 0;
+    sum_ty = 0;
+    sum_u = 0;
+    sum_v = 0;
+    sum_u2 = 0;
+    sum_uv = 0;
+    sum_log_n = 0;
+}
+
+void ir_auto_cal_add_point(float ir_value, float distance) {
+    if (ir_value == 0) return;
+
+    float t = 1.0f / ir_value;
+    float y = distance;
+
+    sum_n++;
+    sum_t += t;
+    sum_y += y;
+    sum_t2 += t*t;
+    sum_ty += t*y;
+
+    if (ir_value > 0 && distance > 0) {
+        float u = logf(ir_value);
+        float v = logf(distance);
+
+        sum_log_n++;
+        sum_u += u;
+        sum_v += v;
+        sum_u2 += u*u;
+        sum_uv += u*v;
+    }
+}
+
+Curve ir_auto_cal_calculate() {
+    double denom = sum_n * sum_t2 - sum_t * sum_t;
+    if (denom == 0) return (Curve) {0, 0, IR_MODEL_HYPERBOLIC};
+
+    double a_hat = (sum_n * sum_ty - sum_t * sum_y) / denom;
+    double b_hat = (sum_y - a_hat * sum_t) / sum_n;
+
+    return (Curve) {a_hat, b_hat, IR_MODEL_HYPERBOLIC};
+}
+
+Curve ir_auto_cal_calculate_model(char fit_model) {
+    if (fit_model != IR_MODEL_POWER) return ir_auto_cal_calculate();
+
+    // ln(d) = ln(a) + b*ln(x), a straight line in log space
+    double denom = sum_log_n * sum_u2 - sum_u * sum_u;
+    if (denom == 0) return (Curve) {0, 0, IR_MODEL_POWER};
+
+    double b_hat = (sum_log_n * sum_uv - sum_u * sum_v) / denom;
+    double ln_a_hat = (sum_v - b_hat * sum_u) / sum_log_n;
+
+    return (Curve) {exp(ln_a_hat), b_hat, IR_MODEL_POWER};
+}
+
+
+
+
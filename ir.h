@@ -1,33 +1,79 @@
-#pragma once
-
-// init the ir scanner
-// does continuous sampling with 16 hardware averages
-void ir_init_fuck();
-
-// reads an ir sample
-int ir_read_sample_fuck();
-
-// reads 16 ir values and returns the lowest
-int ir_floor_sample();
-
-// convert a raw ir sample to cm
-float ir_raw_to_cm(int ir_raw_sample);
-
-
-// call once to start an auto-calibration
-void ir_auto_cal_init();
-
-// add a data point to the auto-calibration. pass the raw ir value and the distance it should map to
-void ir_auto_cal_add_point(float ir_value, float distance);
-
-// after calling ir_auto_cal_add_point a number of times, this method will return the best fit values a and b for the curve y = a/x + b
-typedef struct Curve {
-    float a;
-    float b;
-} Curve;
-
-// automatically calculates the curve values based off of previous calls to ir_auto_cal_add_point()
-Curve ir_auto_cal_calculate();
-
-// set A and k based off of the autocal
-void ir_set_a_b(float v_a, float v_b);
+#pragma once
+
+// number of samples in a burst
+#define IR_BURST_SIZE 8
+
+// how a burst is reduced down to one value
+#define IR_REDUCE_MIN 0
+#define IR_REDUCE_MEDIAN 1
+#define IR_REDUCE_TRIMMED_MEAN 2 // mean of the middle half
+
+// calibration curves from raw ir value x to distance d (cm)
+#define IR_MODEL_HYPERBOLIC 0 // d = a/x + b
+#define IR_MODEL_POWER 1 // d = a * x^b
+
+// raw to cm lookup table. one entry per 16 raw counts (interpolated between), distances in fixed point with 6 fraction bits
+#define IR_LUT_SHIFT 4
+#define IR_LUT_SIZE ((4096 >> IR_LUT_SHIFT) + 1)
+#define IR_LUT_FRAC_BITS 6
+#define IR_LUT_MAX_CM 1000.0f // anything further (or a raw 0) is clamped to this
+
+// init the ir scanner
+// samples in timer triggered bursts with 16 hardware averages, collected by the adc interrupt
+void ir_init_fuck();
+
+// reads an ir sample, the most recent value of the last burst
+int ir_read_sample_fuck();
+
+// starts collecting a burst of IR_BURST_SIZE samples in the background, returns right away
+void ir_burst_start();
+
+// returns 1 once the burst started by ir_burst_start is complete
+char ir_burst_ready();
+
+// reduces the last completed burst to a single raw value with one of the IR_REDUCE_ modes
+int ir_burst_reduce(char mode);
+
+// blocking, takes a burst and reduces it
+int ir_sample(char mode);
+
+// takes a burst of ir values and returns the lowest
+int ir_floor_sample();
+
+// convert a raw ir sample to cm, from the lookup table
+float ir_raw_to_cm(int ir_raw_sample);
+
+// ir_raw_to_cm in fixed point, cm * 2^IR_LUT_FRAC_BITS
+unsigned short ir_raw_to_cm_fixed(int ir_raw_sample);
+
+// expected noise (std dev, cm) of an ir distance, from the slope of the calibrated curve at that distance
+float ir_cm_sigma(float cm);
+
+
+// call once to start an auto-calibration
+void ir_auto_cal_init();
+
+// add a data point to the auto-calibration. pass the raw ir value and the distance it should map to
+void ir_auto_cal_add_point(float ir_value, float distance);
+
+// after calling ir_auto_cal_add_point a number of times, this method will return the best fit values a and b for the curve y = a/x + b
+typedef struct Curve {
+    float a;
+    float b;
+    char model; // one of IR_MODEL_
+} Curve;
+
+// automatically calculates the curve values based off of previous calls to ir_auto_cal_add_point()
+Curve ir_auto_cal_calculate();
+
+// same as ir_auto_cal_calculate, but fits one of the IR_MODEL_ curves
+Curve ir_auto_cal_calculate_model(char fit_model);
+
+// set A and k based off of the autocal, for the hyperbolic curve
+void ir_set_a_b(float v_a, float v_b);
+
+// set the calibration curve to one of the IR_MODEL_ curves and rebuild the lookup table
+void ir_set_model(char v_model, float v_a, float v_b);
+
+// the calibration curve currently in use
+Curve ir_get_model();
@@ -0,0 +1,178 @@
+#pragma once
+
+#include "main_scan_data.h"
+#include "main_occupancy.h"
+#include "movement.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+
+
+// ------------------------------ frontiers ------------------------------
+// a frontier is a known free cell of the occupancy grid next to one that has never been seen. touching frontier cells are
+// grouped into clusters, and each cluster is scored by how much new ground it could show (its size, less if the heat map
+// says we've been around there a lot) over how far it is to get there (distance plus a bit for turning)
+// explore_loop_path tries the clusters best first and only falls back to a random point when none of them can be reached
+
+#define FRONTIER_FREE (-12) // log-odds at or below this is known free, two missed beams
+#define FRONTIER_MIN_CELLS 3 // smaller clusters are noise
+#define FRONTIER_MAX_CLUSTERS 8 // only the best ones are kept
+#define FRONTIER_CLUSTER_CELLS 256 // cells a single cluster can grow to, anything past that starts a new one
+#define FRONTIER_MIN_DIST 400.0f // mm, frontier this close to the bot is for a scan to fill in (like right behind it), not for driving to
+
+#define FRONTIER_TURN_COST 150.0f // mm of driving a radian of turning is worth
+#define FRONTIER_COST_BIAS 300.0f // mm added to every cost so clusters right next to the bot don't win by default
+
+typedef struct frontier_cluster {
+    float x, y; // the target, the cluster cell nearest its middle
+    int cells;
+    float score;
+} frontier_cluster;
+
+frontier_cluster frontiers[FRONTIER_MAX_CLUSTERS];
+int frontiers_c = 0;
+
+static uint64_t frontier_bits[OCC_SIZE]; // bit x of row y is set if that cell is a frontier not yet put in a cluster
+static uint16_t frontier_members[FRONTIER_CLUSTER_CELLS]; // y * OCC_SIZE + x of every cell in the cluster being grown
+
+static inline char frontier_cell_unknown(int gx, int gy) {
+    return gx >= 0 && gx < OCC_SIZE && gy >= 0 && gy < OCC_SIZE && occ_grid[gy][gx] == 0;
+}
+
+// marks every frontier cell in frontier_bits
+static void frontier_mark() {
+    if (occ_inflated_dirty) occ_rebuild_inflated();
+
+    const float near = FRONTIER_MIN_DIST / OCC_CELL;
+    const float bot_gx = get_pos_x() / OCC_CELL - occ_origin_x - 0.5f;
+    const float bot_gy = get_pos_y() / OCC_CELL - occ_origin_y - 0.5f;
+
+    int gx, gy;
+    for (gy = 0; gy < OCC_SIZE; gy++) {
+        frontier_bits[gy] = 0;
+        for (gx = 0; gx < OCC_SIZE; gx++) {
+            // free and somewhere the bot can actually be
+            if (occ_grid[gy][gx] > FRONTIER_FREE || occ_cell_blocked(gx, gy)) continue;
+            if (dist2(gx, gy, bot_gx, bot_gy) < near * near) continue;
+
+            if (frontier_cell_unknown(gx - 1, gy) || frontier_cell_unknown(gx + 1, gy) ||
+                frontier_cell_unknown(gx, gy - 1) || frontier_cell_unknown(gx, gy + 1)) {
+                frontier_bits[gy] |= ((uint64_t) 1) << gx;
+            }
+        }
+    }
+}
+
+// grows the cluster holding (gx, gy) into frontier_members, clearing its cells from frontier_bits. returns the cell count
+static int frontier_grow(int gx, int gy) {
+    int n = 0;
+    int head = 0;
+
+    frontier_bits[gy] &= ~(((uint64_t) 1) << gx);
+    frontier_members[n++] = gy * OCC_SIZE + gx;
+
+    // breadth first over the 8 neighbors, the member list doubles as the queue
+    while (head < n) {
+        const int cx = frontier_members[head] % OCC_SIZE;
+        const int cy = frontier_members[head] / OCC_SIZE;
+        head++;
+
+        int dx, dy;
+        for (dy = -1; dy <= 1; dy++) {
+            const int ny = cy + dy;
+            if (ny < 0 || ny >= OCC_SIZE) continue;
+
+            for (dx = -1; dx <= 1; dx++) {
+                const int nx = cx + dx;
+                if (nx < 0 || nx >= OCC_SIZE) continue;
+                if (!((frontier_bits[ny] >> nx) & 1)) continue;
+                if (n >= FRONTIER_CLUSTER_CELLS) return n;
+
+                frontier_bits[ny] &= ~(((uint64_t) 1) << nx);
+                frontier_members[n++] = ny * OCC_SIZE + nx;
+            }
+        }
+    }
+
+    return n;
+}
+
+// keeps the cluster if it's one of the FRONTIER_MAX_CLUSTERS best, frontiers stays sorted best first
+static void frontier_keep(const frontier_cluster * c) {
+    int i = frontiers_c;
+    if (i >= FRONTIER_MAX_CLUSTERS) {
+        if (c->score <= frontiers[FRONTIER_MAX_CLUSTERS - 1].score) return;
+        i = FRONTIER_MAX_CLUSTERS - 1;
+    }
+    else frontiers_c++;
+
+    while (i > 0 && frontiers[i - 1].score < c->score) {
+        frontiers[i] = frontiers[i - 1];
+        i--;
+    }
+    frontiers[i] = *c;
+}
+
+// finds and scores the frontier clusters around the bot into frontiers. returns how many there are
+int frontier_find() {
+    frontiers_c = 0;
+    frontier_mark();
+
+    const float bx = get_pos_x();
+    const float by = get_pos_y();
+    const float br = get_pos_r() * (M_PI / 180);
+
+    int gx, gy;
+    for (gy = 0; gy < OCC_SIZE; gy++) {
+        while (frontier_bits[gy]) {
+            // lowest set bit in the row
+            gx = 0;
+            while (!((frontier_bits[gy] >> gx) & 1)) gx++;
+
+            const int n = frontier_grow(gx, gy);
+            if (n < FRONTIER_MIN_CELLS) continue;
+
+            // the member nearest the middle, the middle itself can be off the frontier (or inside something) for a curved one
+            float mx = 0, my = 0;
+            int i;
+            for (i = 0; i < n; i++) {
+                mx += frontier_members[i] % OCC_SIZE;
+                my += frontier_members[i] / OCC_SIZE;
+            }
+            mx /= n;
+            my /= n;
+
+            int best = 0;
+            float best_d2 = 1e30f;
+            for (i = 0; i < n; i++) {
+                const float d2 = dist2(frontier_members[i] % OCC_SIZE, frontier_members[i] / OCC_SIZE, mx, my);
+                if (d2 < best_d2) {
+                    best = i;
+                    best_d2 = d2;
+                }
+            }
+
+            frontier_cluster c;
+            c.x = (frontier_members[best] % OCC_SIZE + occ_origin_x + 0.5f) * OCC_CELL;
+            c.y = (frontier_members[best] / OCC_SIZE + occ_origin_y + 0.5f) * OCC_CELL;
+            c.cells = n;
+
+            if (!is_point_free(c.x, c.y)) continue;
+
+            // gain over cost
+            float turn = atan2f(c.y - by, c.x - bx) - br;
+            while (turn > M_PI)   turn -= 2 * M_PI;
+            while (turn < -M_PI)  turn += 2 * M_PI;
+
+            const float gain = n * OCC_CELL / (1 + exp_map_get_weighted_point(c.x, c.y));
+            const float cost = dist(bx, by, c.x, c.y) + fabsf(turn) * FRONTIER_TURN_COST + FRONTIER_COST_BIAS;
+            c.score = gain / cost;
+
+            frontier_keep(&c);
+        }
+    }
+
+    return frontiers_c;
+}
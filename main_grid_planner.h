@@ -0,0 +1,714 @@
+#pragma once
+
+#include "main_scan_data.h"
+#include "main_occupancy.h"
+#include "movement.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+
+
+// ------------------------------ grid planner ------------------------------
+// the grid path_to backends. the map is rasterized into a 24 by 24 grid of 150mm cells (3.6m square) over the start and
+// target, with every cell the bot can't be in set, and then searched with A* (8 neighbors), Theta* (any angle, a cell's
+// parent can be any cell it can see) or d* lite (further down). the path is pulled tight afterwards so it's a few straight legs, not a staircase
+// all the search memory lives in one static arena that every grid search shares, nothing is set up per plan. it's sized to
+// fit next to everything else in the 32KB of ram, about 3.8KB with the d* lite layout. a far target is planned to in
+// pieces anyway (see grid_path_full), so a bigger grid mostly just costs ram
+
+#define GRID_SIZE 24 // at most 32, a row is one uint32_t
+#define GRID_CELL 150.0f // mm
+#define GRID_CELLS (GRID_SIZE * GRID_SIZE)
+#define GRID_HEAP_SIZE 256 // open list entries, stale duplicates included
+#define GRID_REACH ((GRID_SIZE / 2 - 1) * GRID_CELL) // mm from the middle of the grid it can plan to
+
+#define GRID_COST_STRAIGHT 10 // cost of a step, in tenths of a cell
+#define GRID_COST_DIAGONAL 14
+
+#define GRID_ASTAR 0 // path_run_backend passes these as plain numbers, it's compiled before this file
+#define GRID_THETA 1
+
+typedef struct grid_heap_entry {
+    uint16_t f;
+    uint16_t cell;
+} grid_heap_entry;
+
+#define GRID_PATH_MAX_CELLS (GRID_HEAP_SIZE * sizeof(grid_heap_entry) / sizeof(uint16_t)) // a found path, stored over the heap
+
+typedef struct grid_dstar_entry {
+    uint16_t k1, k2; // d* lite's two part key, compared k1 first
+    uint16_t cell;
+} grid_dstar_entry;
+
+// the arena, one layout per search. d* lite keeps its layout between plans, so any other search using the arena throws it away
+static union {
+    struct {
+        uint16_t g[GRID_CELLS];
+        uint16_t parent[GRID_CELLS];
+        grid_heap_entry heap[GRID_HEAP_SIZE];
+    } search;
+    struct {
+        uint16_t g[GRID_CELLS];
+        uint16_t rhs[GRID_CELLS];
+        grid_dstar_entry heap[GRID_HEAP_SIZE];
+    } dstar;
+} grid_arena;
+
+static char grid_dstar_valid = 0; // 1 while the arena holds a d* lite search that can be repaired
+
+static uint32_t grid_blocked[GRID_SIZE]; // bit x of row y is set if the bot can't be in that cell
+static uint32_t grid_closed[GRID_SIZE];
+static int grid_heap_c = 0;
+
+// world cell of grid (0, 0)
+static int grid_origin_x = 0;
+static int grid_origin_y = 0;
+
+#define grid_cell_blocked(x, y) ((grid_blocked[y] >> (x)) & 1)
+
+static inline float grid_center_x(int x) {
+    return (grid_origin_x + x + 0.5f) * GRID_CELL;
+}
+static inline float grid_center_y(int y) {
+    return (grid_origin_y + y + 0.5f) * GRID_CELL;
+}
+
+// world mm to grid cell, -1 if it's off the grid
+static inline int grid_cell_of(float px, float py) {
+    const int x = (int) floorf(px / GRID_CELL) - grid_origin_x;
+    const int y = (int) floorf(py / GRID_CELL) - grid_origin_y;
+    if (x < 0 || x >= GRID_SIZE || y < 0 || y >= GRID_SIZE) return -1;
+    return y * GRID_SIZE + x;
+}
+
+// rebuilds grid_blocked over the grid where it is now. objects are inflated discs, walls and the occupancy grid are checked per cell
+static void grid_rasterize_here() {
+    memset(grid_blocked, 0, sizeof(grid_blocked));
+
+    int i, x, y;
+    for (i = 0; i < object_map_c; i++) {
+        const object_positional *o = &object_map[i];
+        const float r = object_inflated_radius_now(i) + GRID_CELL / 2; // a cell is blocked if any of it could be, not just its center
+
+        const int x0 = MAX(0, (int) floorf((o->x - r) / GRID_CELL) - grid_origin_x);
+        const int x1 = MIN(GRID_SIZE - 1, (int) floorf((o->x + r) / GRID_CELL) - grid_origin_x);
+        const int y0 = MAX(0, (int) floorf((o->y - r) / GRID_CELL) - grid_origin_y);
+        const int y1 = MIN(GRID_SIZE - 1, (int) floorf((o->y + r) / GRID_CELL) - grid_origin_y);
+
+        for (y = y0; y <= y1; y++) {
+            for (x = x0; x <= x1; x++) {
+                if (dist2(grid_center_x(x), grid_center_y(y), o->x, o->y) <= r * r) grid_blocked[y] |= ((uint32_t) 1) << x;
+            }
+        }
+    }
+
+    for (y = 0; y < GRID_SIZE; y++) {
+        for (x = 0; x < GRID_SIZE; x++) {
+            if (grid_cell_blocked(x, y)) continue;
+
+            const float px = grid_center_x(x);
+            const float py = grid_center_y(y);
+
+            char blocked = 0;
+#if OCC_PLANNING
+            blocked = occ_point_blocked(px, py);
+#endif
+            for (i = 0; i < segment_map_c && !blocked; i++) blocked = wall_blocks_point(i, px, py);
+
+            if (blocked) grid_blocked[y] |= ((uint32_t) 1) << x;
+        }
+    }
+}
+
+// moves the grid to be centered on (cx, cy) and rebuilds it
+static void grid_rasterize(float cx, float cy) {
+    grid_origin_x = (int) floorf(cx / GRID_CELL) - GRID_SIZE / 2;
+    grid_origin_y = (int) floorf(cy / GRID_CELL) - GRID_SIZE / 2;
+    grid_rasterize_here();
+}
+
+// min heap on f
+static char grid_heap_push(uint16_t cell, uint16_t f) {
+    if (grid_heap_c >= GRID_HEAP_SIZE) return 0;
+
+    grid_heap_entry *heap = grid_arena.search.heap;
+    int i = grid_heap_c++;
+    while (i > 0 && heap[(i - 1) / 2].f > f) {
+        heap[i] = heap[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    heap[i] = (grid_heap_entry) { f, cell };
+    return 1;
+}
+
+static uint16_t grid_heap_pop() {
+    grid_heap_entry *heap = grid_arena.search.heap;
+    const uint16_t top = heap[0].cell;
+    const grid_heap_entry last = heap[--grid_heap_c];
+
+    int i = 0;
+    while (1) {
+        int child = 2 * i + 1;
+        if (child >= grid_heap_c) break;
+        if (child + 1 < grid_heap_c && heap[child + 1].f < heap[child].f) child++;
+        if (heap[child].f >= last.f) break;
+
+        heap[i] = heap[child];
+        i = child;
+    }
+    if (grid_heap_c > 0) heap[i] = last;
+    return top;
+}
+
+// 1 if the straight line between cells a and b only crosses free cells. diagonal steps need both side cells free too,
+// so a line can't squeeze between two blocked corners
+static char grid_line_clear(int a, int b) {
+    int x0 = a % GRID_SIZE, y0 = a / GRID_SIZE;
+    const int x1 = b % GRID_SIZE, y1 = b / GRID_SIZE;
+
+    // bresenham
+    const int dx = abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+    const int dy = -abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
+    int err = dx + dy;
+
+    while (1) {
+        if (grid_cell_blocked(x0, y0)) return 0;
+        if (x0 == x1 && y0 == y1) return 1;
+
+        const int e2 = 2 * err;
+        const char step_x = e2 >= dy;
+        const char step_y = e2 <= dx;
+
+        if (step_x && step_y && (grid_cell_blocked(x0 + sx, y0) || grid_cell_blocked(x0, y0 + sy))) return 0;
+        if (step_x) { err += dy; x0 += sx; }
+        if (step_y) { err += dx; y0 += sy; }
+    }
+}
+
+// cost between any two cells, tenths of a cell
+static inline uint16_t grid_dist(int a, int b) {
+    const int dx = a % GRID_SIZE - b % GRID_SIZE;
+    const int dy = a / GRID_SIZE - b / GRID_SIZE;
+    return (uint16_t) (sqrtf(dx * dx + dy * dy) * GRID_COST_STRAIGHT + 0.5f);
+}
+
+// octile distance, exact for 8 neighbor moves
+static inline uint16_t grid_octile(int a, int b) {
+    const int dx = abs(a % GRID_SIZE - b % GRID_SIZE);
+    const int dy = abs(a / GRID_SIZE - b / GRID_SIZE);
+    return GRID_COST_STRAIGHT * MAX(dx, dy) + (GRID_COST_DIAGONAL - GRID_COST_STRAIGHT) * MIN(dx, dy);
+}
+
+unsigned int grid_expansions = 0; // cells closed by the last search
+
+// A* or Theta* from start to goal over grid_blocked. fills g and parent, returns 1 if the goal was reached
+static char grid_search(int start, int goal, char mode) {
+    uint16_t *g = grid_arena.search.g;
+    uint16_t *parent = grid_arena.search.parent;
+
+    memset(g, 0xFF, sizeof(grid_arena.search.g));
+    memset(grid_closed, 0, sizeof(grid_closed));
+    grid_dstar_valid = 0;
+    grid_heap_c = 0;
+    grid_expansions = 0;
+
+    g[start] = 0;
+    parent[start] = start;
+    grid_heap_push(start, mode == GRID_THETA ? grid_dist(start, goal) : grid_octile(start, goal));
+
+    while (grid_heap_c > 0) {
+        const int cell = grid_heap_pop();
+        const int cx = cell % GRID_SIZE;
+        const int cy = cell / GRID_SIZE;
+
+        if ((grid_closed[cy] >> cx) & 1) continue; // a stale duplicate
+        if (cell == goal) return 1;
+
+        grid_closed[cy] |= ((uint32_t) 1) << cx;
+        grid_expansions++;
+
+        int dx, dy;
+        for (dy = -1; dy <= 1; dy++) {
+            for (dx = -1; dx <= 1; dx++) {
+                const int nx = cx + dx;
+                const int ny = cy + dy;
+                if ((dx == 0 && dy == 0) || nx < 0 || nx >= GRID_SIZE || ny < 0 || ny >= GRID_SIZE) continue;
+                if (grid_cell_blocked(nx, ny) || ((grid_closed[ny] >> nx) & 1)) continue;
+
+                // no cutting corners
+                if (dx != 0 && dy != 0 && (grid_cell_blocked(cx + dx, cy) || grid_cell_blocked(cx, cy + dy))) continue;
+
+                const int next = ny * GRID_SIZE + nx;
+
+                // theta* skips this cell entirely when its parent can see the neighbor
+                int from = cell;
+                uint16_t cost = g[cell] + ((dx != 0 && dy != 0) ? GRID_COST_DIAGONAL : GRID_COST_STRAIGHT);
+                if (mode == GRID_THETA && parent[cell] != cell && grid_line_clear(parent[cell], next)) {
+                    from = parent[cell];
+                    cost = g[from] + grid_dist(from, next);
+                }
+
+                if (cost >= g[next]) continue;
+
+                g[next] = cost;
+                parent[next] = from;
+                if (!grid_heap_push(next, cost + (mode == GRID_THETA ? grid_dist(next, goal) : grid_octile(next, goal)))) {
+                    ur_send_line("Warning: grid planner open list full");
+                    return 0;
+                }
+            }
+        }
+    }
+
+    return 0;
+}
+
+// centers the grid over (sx, sy) and the target and rasterizes it. a target past the grid's reach is moved in as far along
+// the straight line as the grid goes (and back out of anything it lands in), (gx, gy) is where it ended up
+// returns the goal cell, or -1 if there isn't a usable one
+static int grid_place(float sx, float sy, float tx, float ty, float *gx, float *gy) {
+    const float length = dist(sx, sy, tx, ty);
+
+    *gx = tx;
+    *gy = ty;
+    if (length > 2 * GRID_REACH) {
+        *gx = sx + (tx - sx) * (2 * GRID_REACH / length);
+        *gy = sy + (ty - sy) * (2 * GRID_REACH / length);
+    }
+
+    grid_rasterize((sx + *gx) / 2, (sy + *gy) / 2);
+
+    const int start = grid_cell_of(sx, sy);
+    int goal = grid_cell_of(*gx, *gy);
+    if (start == -1 || goal == -1) return -1;
+
+    // a cut short goal can land in something, back up along the line to a free cell
+    if (*gx != tx || *gy != ty) {
+        float t = 1;
+        while (grid_cell_blocked(goal % GRID_SIZE, goal / GRID_SIZE) && t > 0) {
+            t -= 0.05f;
+            *gx = sx + (tx - sx) * (2 * GRID_REACH / length) * t;
+            *gy = sy + (ty - sy) * (2 * GRID_REACH / length) * t;
+            goal = grid_cell_of(*gx, *gy);
+        }
+    }
+    if (grid_cell_blocked(goal % GRID_SIZE, goal / GRID_SIZE) || goal == start) return -1;
+
+    return goal;
+}
+
+// plans from (sx, sy) to (tx, ty) over the grid with mode (GRID_ASTAR or GRID_THETA), same contract as path_to_full
+// a target past the grid's reach is planned to as far along the straight line as the grid goes, the explore loop re-plans
+// every step so it gets the rest later
+int grid_path_full(float sx, float sy, float tx, float ty, float *wx, float *wy, int max_waypoints, char mode) {
+    float gx, gy;
+    const int goal = grid_place(sx, sy, tx, ty, &gx, &gy);
+    if (goal == -1) return 0;
+
+    const int start = grid_cell_of(sx, sy);
+
+    // the bot can be in a cell the inflation covers (it's allowed to brush things), the search starts there regardless
+    const uint32_t start_row = grid_blocked[start / GRID_SIZE];
+    grid_blocked[start / GRID_SIZE] &= ~(((uint32_t) 1) << (start % GRID_SIZE));
+
+    const char found = grid_search(start, goal, mode);
+    if (!found) {
+        grid_blocked[start / GRID_SIZE] = start_row;
+        return 0;
+    }
+
+    // the cells from the start to the goal, in the heap's space now that the search is done
+    uint16_t *cells = (uint16_t *) grid_arena.search.heap;
+    const int max_cells = GRID_PATH_MAX_CELLS;
+
+    int n = 0;
+    int c;
+    for (c = goal; c != start && n < max_cells; c = grid_arena.search.parent[c]) n++;
+    if (n >= max_cells) {
+        grid_blocked[start / GRID_SIZE] = start_row;
+        return 0;
+    }
+
+    int i = n;
+    for (c = goal; c != start; c = grid_arena.search.parent[c]) cells[i--] = c;
+    cells[0] = start;
+
+    // pull the path tight, from each corner go to the farthest cell it can still see. the raster is only close to the real
+    // map, so a leg is also checked exactly, and it falls back a cell at a time until it passes (neighbors always can't, but
+    // they're a cell apart so that's as close as the grid can get)
+    int out = 0;
+    int anchor = 0;
+    float ax = sx, ay = sy;
+    while (anchor < n) {
+        int j = anchor + 1;
+        while (j < n && grid_line_clear(cells[anchor], cells[j + 1])) j++;
+
+        float bx, by;
+        while (1) {
+            bx = (j == n) ? gx : grid_center_x(cells[j] % GRID_SIZE);
+            by = (j == n) ? gy : grid_center_y(cells[j] / GRID_SIZE);
+            if (j == anchor + 1 || segment_clear(ax, ay, bx, by)) break;
+            j--;
+        }
+
+        if (out < max_waypoints) {
+            wx[out] = bx;
+            wy[out] = by;
+        }
+        out++;
+        anchor = j;
+        ax = bx;
+        ay = by;
+    }
+
+    grid_blocked[start / GRID_SIZE] = start_row;
+    return out;
+}
+
+
+
+// ------------------------------ incremental grid planner ------------------------------
+// d* lite over the same grid. it searches back from the goal and keeps its g / rhs values between plans, so asking for the
+// same target again only repairs the cells whose blocked bit flipped since last time (and their neighbors), and the bot
+// having moved just shifts the keys by km. a scan or bump that changes a couple of objects costs a couple of objects' worth
+// the grid stays put for a target. it's only moved (and the search started over) for a new target, when the bot leaves it,
+// or when the bot is getting close to a target that was cut short to fit
+
+#define GRID_INF 0xFFFF
+
+static uint32_t grid_dstar_blocked[GRID_SIZE]; // grid_blocked as of the last plan, to find what changed
+static int grid_dstar_start = 0;
+static int grid_dstar_goal = 0;
+static float grid_dstar_tx = 0, grid_dstar_ty = 0; // the target asked for
+static float grid_dstar_gx = 0, grid_dstar_gy = 0; // where the goal ended up, different if it was cut short
+static int grid_dstar_origin_x = 0, grid_dstar_origin_y = 0; // where the grid was for it
+static uint16_t grid_dstar_km = 0;
+static int grid_dstar_heap_c = 0;
+static char grid_dstar_overflow = 0;
+static char grid_dstar_fallback = 0; // 1 once the open list overflowed for the current target, it's planned with A* until the target changes
+
+unsigned int grid_dstar_changed = 0; // cells that flipped before the last plan
+unsigned int grid_dstar_plans = 0;
+unsigned int grid_dstar_restarts = 0; // plans that started the search over
+unsigned int grid_dstar_total_changed = 0;
+unsigned int grid_dstar_total_expansions = 0;
+unsigned int grid_dstar_fallbacks = 0; // targets handed to A* after an overflow
+
+static inline uint16_t grid_add(uint16_t a, uint16_t b) {
+    const uint32_t sum = (uint32_t) a + b;
+    return sum >= GRID_INF ? GRID_INF : (uint16_t) sum;
+}
+
+static inline uint32_t grid_dstar_entry_key(const grid_dstar_entry * e) {
+    return ((uint32_t) e->k1 << 16) | e->k2;
+}
+
+static inline uint32_t grid_dstar_key(int cell) {
+    const uint16_t m = MIN(grid_arena.dstar.g[cell], grid_arena.dstar.rhs[cell]);
+    const uint16_t k1 = grid_add(grid_add(m, grid_octile(grid_dstar_start, cell)), grid_dstar_km);
+    return ((uint32_t) k1 << 16) | m;
+}
+
+// cost of the step between neighbor cells a and b, GRID_INF if it can't be taken
+static inline uint16_t grid_step_cost(int a, int b) {
+    const int ax = a % GRID_SIZE, ay = a / GRID_SIZE;
+    const int bx = b % GRID_SIZE, by = b / GRID_SIZE;
+    if (grid_cell_blocked(ax, ay) || grid_cell_blocked(bx, by)) return GRID_INF;
+
+    if (ax != bx && ay != by) {
+        if (grid_cell_blocked(bx, ay) || grid_cell_blocked(ax, by)) return GRID_INF; // no cutting corners
+        return GRID_COST_DIAGONAL;
+    }
+    return GRID_COST_STRAIGHT;
+}
+
+// min heap on the key
+static char grid_dstar_heap_insert(int cell) {
+    if (grid_dstar_heap_c >= GRID_HEAP_SIZE) return 0;
+
+    const uint32_t key = grid_dstar_key(cell);
+    grid_dstar_entry *heap = grid_arena.dstar.heap;
+    int i = grid_dstar_heap_c++;
+    while (i > 0 && grid_dstar_entry_key(&heap[(i - 1) / 2]) > key) {
+        heap[i] = heap[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    heap[i] = (grid_dstar_entry) { key >> 16, key & 0xFFFF, cell };
+    return 1;
+}
+
+static void grid_dstar_heap_pop() {
+    grid_dstar_entry *heap = grid_arena.dstar.heap;
+    const grid_dstar_entry last = heap[--grid_dstar_heap_c];
+    const uint32_t last_key = grid_dstar_entry_key(&last);
+
+    int i = 0;
+    while (1) {
+        int child = 2 * i + 1;
+        if (child >= grid_dstar_heap_c) break;
+        if (child + 1 < grid_dstar_heap_c && grid_dstar_entry_key(&heap[child + 1]) < grid_dstar_entry_key(&heap[child])) child++;
+        if (grid_dstar_entry_key(&heap[child]) >= last_key) break;
+
+        heap[i] = heap[child];
+        i = child;
+    }
+    if (grid_dstar_heap_c > 0) heap[i] = last;
+}
+
+// puts cell on the open list. stale entries are left in and skipped when popped, so if it fills up it's rebuilt with
+// one entry per cell that is actually still inconsistent
+static void grid_dstar_queue(int cell) {
+    if (grid_dstar_heap_insert(cell)) return;
+
+    grid_dstar_heap_c = 0;
+    int c;
+    for (c = 0; c < GRID_CELLS; c++) {
+        if (grid_arena.dstar.g[c] != grid_arena.dstar.rhs[c] && !grid_dstar_heap_insert(c)) {
+            grid_dstar_overflow = 1;
+            return;
+        }
+    }
+}
+
+// recomputes rhs of a cell from its neighbors and queues it if that makes it inconsistent
+static void grid_dstar_update(int cell) {
+    uint16_t *g = grid_arena.dstar.g;
+    uint16_t *rhs = grid_arena.dstar.rhs;
+
+    if (cell != grid_dstar_goal) {
+        const int cx = cell % GRID_SIZE;
+        const int cy = cell / GRID_SIZE;
+
+        uint16_t best = GRID_INF;
+        int dx, dy;
+        for (dy = -1; dy <= 1; dy++) {
+            for (dx = -1; dx <= 1; dx++) {
+                const int nx = cx + dx;
+                const int ny = cy + dy;
+                if ((dx == 0 && dy == 0) || nx < 0 || nx >= GRID_SIZE || ny < 0 || ny >= GRID_SIZE) continue;
+
+                const int next = ny * GRID_SIZE + nx;
+                const uint16_t cost = grid_add(grid_step_cost(cell, next), g[next]);
+                if (cost < best) best = cost;
+            }
+        }
+        rhs[cell] = best;
+    }
+
+    if (g[cell] != rhs[cell]) grid_dstar_queue(cell);
+}
+
+// runs grid_dstar_update on a cell and all 8 of its neighbors
+static void grid_dstar_update_around(int cell) {
+    const int cx = cell % GRID_SIZE;
+    const int cy = cell / GRID_SIZE;
+
+    int dx, dy;
+    for (dy = -1; dy <= 1; dy++) {
+        for (dx = -1; dx <= 1; dx++) {
+            const int nx = cx + dx;
+            const int ny = cy + dy;
+            if (nx < 0 || nx >= GRID_SIZE || ny < 0 || ny >= GRID_SIZE) continue;
+            grid_dstar_update(ny * GRID_SIZE + nx);
+        }
+    }
+}
+
+// expands until the start is consistent and nothing left on the open list could improve it. returns 0 if the open list overflowed
+static char grid_dstar_compute() {
+    uint16_t *g = grid_arena.dstar.g;
+    uint16_t *rhs = grid_arena.dstar.rhs;
+    const int start = grid_dstar_start;
+
+    grid_expansions = 0;
+    while (grid_dstar_heap_c > 0 && !grid_dstar_overflow) {
+        const grid_dstar_entry top = grid_arena.dstar.heap[0];
+        const uint32_t key_old = grid_dstar_entry_key(&top);
+        if (key_old >= grid_dstar_key(start) && g[start] == rhs[start]) break;
+
+        grid_dstar_heap_pop();
+        const int cell = top.cell;
+        if (g[cell] == rhs[cell]) continue; // a stale duplicate
+
+        // queued before the bot moved, put it back with its real key
+        if (key_old < grid_dstar_key(cell)) {
+            grid_dstar_queue(cell);
+            continue;
+        }
+
+        grid_expansions++;
+        if (g[cell] > rhs[cell]) g[cell] = rhs[cell]; // got cheaper
+        else                     g[cell] = GRID_INF; // got more expensive, the neighbors and itself are redone below
+        grid_dstar_update_around(cell);
+    }
+
+    return !grid_dstar_overflow;
+}
+
+// starts the search over for the goal cell
+static void grid_dstar_reset(int start, int goal) {
+    memset(grid_arena.dstar.g, 0xFF, sizeof(grid_arena.dstar.g));
+    memset(grid_arena.dstar.rhs, 0xFF, sizeof(grid_arena.dstar.rhs));
+    grid_dstar_heap_c = 0;
+    grid_dstar_overflow = 0;
+    grid_dstar_km = 0;
+    grid_dstar_start = start;
+    grid_dstar_goal = goal;
+
+    grid_arena.dstar.rhs[goal] = 0;
+    grid_dstar_queue(goal);
+
+    grid_dstar_valid = 1;
+    grid_dstar_restarts++;
+}
+
+// plans from (sx, sy) to (tx, ty) with d* lite, reusing the last search when the target is the same. same contract as path_to_full
+int grid_dstar_path_full(float sx, float sy, float tx, float ty, float *wx, float *wy, int max_waypoints) {
+    uint16_t *g = grid_arena.dstar.g;
+
+    // an overflow would only happen again for the same target, a cluttered grid doesn't get any less cluttered
+    if (grid_dstar_fallback) {
+        if (tx == grid_dstar_tx && ty == grid_dstar_ty) return grid_path_full(sx, sy, tx, ty, wx, wy, max_waypoints, GRID_ASTAR);
+        grid_dstar_fallback = 0;
+    }
+
+    const char cut_short = grid_dstar_gx != grid_dstar_tx || grid_dstar_gy != grid_dstar_ty;
+    int start = -1;
+    if (grid_dstar_valid && tx == grid_dstar_tx && ty == grid_dstar_ty) {
+        grid_origin_x = grid_dstar_origin_x;
+        grid_origin_y = grid_dstar_origin_y;
+        start = grid_cell_of(sx, sy);
+
+        // move on to the next stretch of a cut short target once the bot is about halfway to the first one
+        if (cut_short && dist(sx, sy, grid_dstar_gx, grid_dstar_gy) < GRID_REACH) start = -1;
+    }
+
+    grid_dstar_changed = 0;
+    if (start != -1) {
+        // same search, find what changed
+        grid_rasterize_here();
+        grid_blocked[start / GRID_SIZE] &= ~(((uint32_t) 1) << (start % GRID_SIZE)); // the bot can brush things, see grid_path_full
+
+        grid_dstar_km = grid_add(grid_dstar_km, grid_octile(grid_dstar_start, start));
+        grid_dstar_start = start;
+
+        int x, y;
+        for (y = 0; y < GRID_SIZE; y++) {
+            const uint32_t flipped = grid_blocked[y] ^ grid_dstar_blocked[y];
+            if (!flipped) continue;
+
+            for (x = 0; x < GRID_SIZE; x++) {
+                if (!((flipped >> x) & 1)) continue;
+
+                grid_dstar_update_around(y * GRID_SIZE + x);
+                grid_dstar_changed++;
+            }
+        }
+    }
+    else {
+        // new search
+        float gx, gy;
+        const int goal = grid_place(sx, sy, tx, ty, &gx, &gy);
+        if (goal == -1) {
+            grid_dstar_valid = 0;
+            return 0;
+        }
+
+        start = grid_cell_of(sx, sy);
+        grid_blocked[start / GRID_SIZE] &= ~(((uint32_t) 1) << (start % GRID_SIZE));
+
+        grid_dstar_tx = tx;
+        grid_dstar_ty = ty;
+        grid_dstar_gx = gx;
+        grid_dstar_gy = gy;
+        grid_dstar_origin_x = grid_origin_x;
+        grid_dstar_origin_y = grid_origin_y;
+        grid_dstar_reset(start, goal);
+    }
+
+    memcpy(grid_dstar_blocked, grid_blocked, sizeof(grid_blocked));
+
+    const char computed = grid_dstar_compute();
+    grid_dstar_plans++;
+    grid_dstar_total_changed += grid_dstar_changed;
+    grid_dstar_total_expansions += grid_expansions;
+
+    if (!computed) {
+        ur_send_line("Warning: grid planner open list full, planning this target with A*");
+        grid_dstar_valid = 0;
+        grid_dstar_fallback = 1;
+        grid_dstar_fallbacks++;
+        return grid_path_full(sx, sy, tx, ty, wx, wy, max_waypoints, GRID_ASTAR);
+    }
+
+    if (g[start] == GRID_INF) {
+        if (cut_short) grid_dstar_valid = 0; // try a different cut next time
+        return 0;
+    }
+
+    // walk down g from the start, pulling the path tight on the way like grid_path_full does
+    const int goal = grid_dstar_goal;
+    int out = 0;
+    int anchor = start;
+    int cell = start;
+    float ax = sx, ay = sy;
+    int steps = 0;
+
+    while (cell != goal) {
+        const int cx = cell % GRID_SIZE;
+        const int cy = cell / GRID_SIZE;
+
+        int next = -1;
+        uint16_t best = GRID_INF;
+        int dx, dy;
+        for (dy = -1; dy <= 1; dy++) {
+            for (dx = -1; dx <= 1; dx++) {
+                const int nx = cx + dx;
+                const int ny = cy + dy;
+                if ((dx == 0 && dy == 0) || nx < 0 || nx >= GRID_SIZE || ny < 0 || ny >= GRID_SIZE) continue;
+
+                const int n = ny * GRID_SIZE + nx;
+                const uint16_t cost = grid_add(grid_step_cost(cell, n), g[n]);
+                if (cost < best) {
+                    best = cost;
+                    next = n;
+                }
+            }
+        }
+        if (next == -1 || ++steps > GRID_CELLS) return 0; // can't happen with a consistent search, but don't spin if it does
+
+        const float nx = (next == goal) ? grid_dstar_gx : grid_center_x(next % GRID_SIZE);
+        const float ny = (next == goal) ? grid_dstar_gy : grid_center_y(next / GRID_SIZE);
+
+        // the corner is the last cell the anchor could see
+        if (cell != anchor && !(grid_line_clear(anchor, next) && segment_clear(ax, ay, nx, ny))) {
+            ax = grid_center_x(cx);
+            ay = grid_center_y(cy);
+            if (out < max_waypoints) {
+                wx[out] = ax;
+                wy[out] = ay;
+            }
+            out++;
+            anchor = cell;
+        }
+
+        cell = next;
+    }
+
+    if (out < max_waypoints) {
+        wx[out] = grid_dstar_gx;
+        wy[out] = grid_dstar_gy;
+    }
+    return out + 1;
+}
+
+// prints how much of its work d* lite has been able to reuse
+void grid_dstar_print_stats() {
+    char buff[128];
+    sprintf(buff, "d* lite - plans: %u, restarts: %u, avg changed cells: %u, avg expansions: %u, fallbacks: %u", grid_dstar_plans, grid_dstar_restarts,
+            grid_dstar_plans ? grid_dstar_total_changed / grid_dstar_plans : 0, grid_dstar_plans ? grid_dstar_total_expansions / grid_dstar_plans : 0,
+            grid_dstar_fallbacks);
+    ur_send_line(buff);
+}
@@ -1,156 +1,513 @@
-#pragma once
-
-
-
-#include "main_scan_data.h"
-#include "scan.h"
-
-void update_object_map();
-
-// scans, converts to objects, re-pings for accurate distances, and adds them to the map. updates python data packet
-void perform_scan_and_obj_detection() {
-    objects_c = 0;
-
-    ur_send_line("scanning...");
-
-
-    // gather data
-    sc_sweep_ir(data);
-
-    sc_clean_scan(data, SCAN_BUFFER_SIZE);
-//    sc_print_sweep(data, SCAN_BUFFER_SIZE);
-
-    // convert to objects
-    sc_find_objects(data, SCAN_BUFFER_SIZE, SCAN_MAX_DISTANCE, 4, objects, &objects_c);
-
-
-    // no objects
-    if (objects_c == 0) {
-        ur_send_line("no objects found");
-        return;
-    }
-
-    // get better object data
-    sc_reping_objects(objects, objects_c);
-
-    // populate object size values
-    sc_calc_size_objects(objects, objects_c);
-
-    // print out the objects
-//    sc_print_objects(objects, objects_c);
-
-    // updates the object map
-    update_object_map();
-
-    send_data_packet(object_map, object_map_c, 1); // update python data packet
-}
-
-// unused. finds the smallest radius object in object_map
-int find_smallest_object_index() {
-    if (object_map_c == 0) {
-        ur_send_line("Warning: tried calling find_smallest_object_index with no objects detected");
-        return -1;
-    }
-
-    int i;
-    int smallest_index = 0;
-    float smallest_size = object_map[0].radius;
-    for (i = 1; i < object_map_c; i++) {
-        if (object_map[i].radius < smallest_size) {
-            smallest_size = object_map[i].radius;
-            smallest_index = i;
-        }
-    }
-    return smallest_index;
-}
-
-
-
-
-
-// removes object from the object_map and decrements object_map_c
-void remove_object_from_map(int index) {
-    int i;
-    for (i = index; i < object_map_c - 1; i++) {
-        object_map[i] = object_map[i+1]; // left shift to fill the removed space
-    }
-    object_map_c--;
-}
-
-// special function for adding walls that detects for duplicate walls and removes the old
-void add_wall_object(float x, float y, float r) {
-    // remove all now irrelevant walls
-    int i;
-    for (i = 0; i < object_map_c; i++) {
-
-        // basic info about the object
-        const float dy = object_map[i].y - y;
-        const float dx = object_map[i].x - x;
-
-        const float dist_bearing = sqrtf(dx*dx + dy*dy);
-
-        // border (white) objects dissapear when another one roughly takes its place
-        if (object_map[i].type == 3) {
-
-            if (dist_bearing < r) {
-//                ur_send_line("removing border cos it's a stupid little bitch");
-                remove_object_from_map(i);
-                i--;
-            }
-        }
-    }
-
-    // add the wall
-    object_map[object_map_c] = (object_positional) { x, y, r, (char) (3) };
-    object_map_c++;
-}
-
-// take the data from objects array and applies it to object_map using robot relative position
-// also removes duplicate-scanned objects in front of it
-void update_object_map() {
-
-    // remove all now irrelevant objects
-    int i;
-    for (i = 0; i < object_map_c; i++) {
-
-        // basic info about the object
-        const float dy = object_map[i].y - get_pos_y();
-        const float dx = object_map[i].x - get_pos_x();
-
-        const float dist_bearing = sqrtf(dx*dx + dy*dy);
-
-        // tall objects disappear when we re-scan over their cone
-        if (object_map[i].type == 1) {
-
-            // calculate bearing and distance from robot
-            float angle_bearing = atan2f(dy, dx) * (180 / M_PI) - get_pos_r();
-
-            // find how "in front" it is
-            float relative_x = cosf(angle_bearing * (M_PI / 180)) * dist_bearing;
-
-            // remove objects that are "in front", ie positive x, plus a bit of margin, up to a radial distance
-            if (dist_bearing < 150 || (dist_bearing <= (SCAN_MAX_DISTANCE * 10) && (relative_x - object_map[i].radius > 50))) {
-                remove_object_from_map(i);
-                i--;
-            }
-
-//            char buff[128];
-//            sprintf(buff, "object index %d: (%.2f, %.2f) -> %.2f", i, dist_bearing, angle_bearing, relative_x);
-//            ur_send_line(buff);
-        }
-    }
-
-    // add the newly scanned objects
-    for (i = 0; i < objects_c; i++) {
-        // object rel pos
-        float tx = (objects[i].distance + objects[i].size / 2.0f) * 10 * cosf((objects[i].angle - 90 + get_pos_r()) * (M_PI / 180));
-        float ty = (objects[i].distance + objects[i].size / 2.0f) * 10 * sinf((objects[i].angle - 90 + get_pos_r()) * (M_PI / 180));
-
-        // scanner offset
-        tx += 90 * cosf(get_pos_r() * (M_PI / 180));
-        ty += 90 * sinf(get_pos_r() * (M_PI / 180));
-
-        object_map[object_map_c] = (object_positional) { get_pos_x() + tx, get_pos_y() + ty, objects[i].size * 10 / 2, (char) 1 };
-        object_map_c++;
-    }
-}
+#pragma once
+
+#include <float.h>
+
+#include "main_scan_data.h"
+#include "main_scan_cache.h"
+#include "main_occupancy.h"
+#include "main_segments.h"
+#include "scan.h"
+
+void update_object_map(int start_angle, int end_angle, const char * reused);
+void perform_sector_scan_and_obj_detection(int start_angle, int end_angle, int resolution);
+
+
+
+// scans, converts to objects, gets accurate distances from the ping, and adds them to the map. updates python data packet
+void perform_scan_and_obj_detection() {
+    perform_sector_scan_and_obj_detection(0, 180, SCAN_RESOLUTION);
+}
+
+// perform_scan_and_obj_detection for only the servo window [start_angle, end_angle], moving resolution degrees per sample
+// only objects in that window are fused into the map. skipped if the scan cache already has the whole window from about this pose
+void perform_sector_scan_and_obj_detection(int start_angle, int end_angle, int resolution) {
+    objects_c = 0;
+
+    ur_send_line("scanning...");
+
+    // anything outside of the window is left as no data
+    int i;
+    for (i = 0; i < SCAN_BUFFER_SIZE; i++) data[i] = fused_data[i] = SCAN_NO_DATA;
+
+    // gather data, only sweeping what the cache doesn't have. a full hit means the map already has these objects
+    char reused[SCAN_BUFFER_SIZE];
+    if (!scan_cache_sweep(data, fused_data, start_angle, end_angle, resolution, reused)) {
+        ur_send_line("scan cache hit, skipping sweep");
+        return;
+    }
+
+    sc_clean_scan_with(data, SCAN_BUFFER_SIZE, SCAN_IR_FILTER);
+#if SCAN_FUSED_SWEEP
+    sc_clean_scan_with(fused_data, SCAN_BUFFER_SIZE, SCAN_FUSED_FILTER);
+#endif
+//    sc_print_sweep(data, SCAN_BUFFER_SIZE);
+
+    // carve the freshly swept part into the occupancy grid. the part from the cache was carved when it was swept, doing it
+    // again would count the same samples twice
+#if SCAN_FUSED_SWEEP
+    float * carve = fused_data;
+#else
+    float * carve = data;
+#endif
+    int run_start = -1;
+    for (i = start_angle; i <= end_angle + SCAN_RESOLUTION; i += SCAN_RESOLUTION) {
+        const char fresh = i <= end_angle && !reused[i / SCAN_RESOLUTION];
+        if (fresh && run_start == -1) run_start = i;
+        if (!fresh && run_start != -1) {
+            occ_update_from_sweep(carve, run_start, i - SCAN_RESOLUTION);
+            run_start = -1;
+        }
+    }
+
+    // pull out straight walls first
+    char used[SCAN_BUFFER_SIZE] = {0};
+    extract_wall_segments(data, start_angle, end_angle, used);
+
+    // convert to objects, anything on a wall is part of the wall. objects centered in the reused part were already fused
+    // when it was swept, so they're dropped too (the whole window is still searched, so ones on the edge of it are found)
+    sc_find_objects_sector(data, SCAN_BUFFER_SIZE, SCAN_MAX_DISTANCE, 4, start_angle, end_angle, objects, &objects_c);
+    for (i = 0; i < objects_c; i++) {
+        const int a = objects[i].angle - SWEEP_ANGLE_COMP;
+        const int n = a / SCAN_RESOLUTION;
+        if (n >= 0 && n < SCAN_BUFFER_SIZE && (reused[n] || used[n])) objects[i--] = objects[--objects_c];
+    }
+
+
+    // no objects, still update the map so objects that should have been seen fade out
+    if (objects_c == 0) {
+        ur_send_line("no objects found");
+    }
+    else {
+        // get better object data
+#if SCAN_FUSED_SWEEP
+        sc_objects_distance_from_sweep(objects, objects_c, fused_data, SCAN_BUFFER_SIZE);
+#else
+        sc_reping_objects(objects, objects_c);
+#endif
+
+        // populate object size values
+        sc_calc_size_objects(objects, objects_c);
+    }
+
+    // print out the objects
+//    sc_print_objects(objects, objects_c);
+
+    // updates the object map
+    update_object_map(start_angle, end_angle, reused);
+
+    send_data_packet(object_map, object_map_c, 1); // update python data packet
+}
+
+// unused. finds the smallest radius object in object_map
+int find_smallest_object_index() {
+    if (object_map_c == 0) {
+        ur_send_line("Warning: tried calling find_smallest_object_index with no objects detected");
+        return -1;
+    }
+
+    int i;
+    int smallest_index = 0;
+    float smallest_size = object_map[0].radius;
+    for (i = 1; i < object_map_c; i++) {
+        if (object_map[i].radius < smallest_size) {
+            smallest_size = object_map[i].radius;
+            smallest_index = i;
+        }
+    }
+    return smallest_index;
+}
+
+
+
+
+
+// removes object from the object_map and decrements object_map_c
+// the last object is moved into the gap, so only that one changes index. loops that remove as they go should re-check index
+void remove_object_from_map(int index) {
+    object_map_c--;
+    if (index != object_map_c) object_map[index] = object_map[object_map_c];
+    object_map_version++;
+}
+
+// finds the current index of the object with the stable id, or -1 if it's no longer on the map
+int object_index_of(unsigned short id) {
+    int i;
+    for (i = 0; i < object_map_c; i++) {
+        if (object_map[i].id == id) return i;
+    }
+    return -1;
+}
+
+
+
+// ------------------------------ object store ------------------------------
+// object_map is a fixed pool of OBJECT_MAP_SIZE objects. everything that adds to it goes through add_object_to_map, which
+// evicts an existing object by OBJECT_EVICT_POLICY when it's full instead of running off the end of the array
+
+#define OBJ_EVICT_LRU 0 // least recently observed
+#define OBJ_EVICT_FARTHEST 1 // farthest from the bot
+#define OBJ_EVICT_LOW_CONFIDENCE 2 // lowest confidence, oldest on a tie
+#define OBJECT_EVICT_POLICY OBJ_EVICT_LRU
+
+// confidence given to new objects by how they were found
+#define OBJ_CONFIDENCE_SCAN 128
+#define OBJ_CONFIDENCE_CONTACT 255 // bumped or driven over
+
+// position variance (mm^2) of objects that weren't placed by a scan
+#define OBJ_VARIANCE_DEFAULT (50.0f * 50.0f)
+
+// usage stats, see object_store_print_stats
+unsigned int object_store_adds = 0;
+static unsigned short object_store_next_id = 1;
+unsigned int object_store_evictions = 0;
+unsigned int object_store_rejects = 0;
+int object_store_peak = 0;
+
+// picks the object to drop per OBJECT_EVICT_POLICY. walls (white border) are only dropped if there is nothing else
+static int object_store_pick_eviction() {
+    const unsigned int now = timer_getMillis();
+    int best = -1;
+    float best_score = 0;
+
+    int pass;
+    for (pass = 0; pass < 2 && best == -1; pass++) {
+        int i;
+        for (i = 0; i < object_map_c; i++) {
+            const object_positional *o = &object_map[i];
+            if (pass == 0 && o->type == 3) continue;
+
+            // lowest confidence first, then the one seen longest ago. kept as integers, folding both into one float
+            // score lost the age once the confidence term got big
+            if (OBJECT_EVICT_POLICY == OBJ_EVICT_LOW_CONFIDENCE) {
+                if (best == -1) best = i;
+                else {
+                    const object_positional *b = &object_map[best];
+                    if (o->confidence < b->confidence ||
+                        (o->confidence == b->confidence && now - o->last_seen > now - b->last_seen)) best = i;
+                }
+                continue;
+            }
+
+            // higher score is evicted first
+            float score;
+            if (OBJECT_EVICT_POLICY == OBJ_EVICT_FARTHEST) score = dist2(o->x, o->y, get_pos_x(), get_pos_y());
+            else                                           score = now - o->last_seen;
+
+            if (best == -1 || score > best_score) {
+                best = i;
+                best_score = score;
+            }
+        }
+    }
+
+    return best;
+}
+
+// adds an object to object_map, evicting one if the store is full. returns its index, or -1 if it could not be added
+int add_object_to_map(float x, float y, float r, char type, unsigned char confidence) {
+    if (object_map_c >= OBJECT_MAP_SIZE) {
+        const int evict = object_store_pick_eviction();
+        if (evict == -1) {
+            object_store_rejects++;
+            ur_send_line("Warning: object store full, object dropped");
+            return -1;
+        }
+
+        remove_object_from_map(evict);
+        object_store_evictions++;
+    }
+
+    // ids only wrap after 65535 adds, skip any still held by an old object
+    while (object_store_next_id == 0 || object_index_of(object_store_next_id) != -1) object_store_next_id++;
+
+    object_map[object_map_c] = (object_positional) {
+        .x = x,
+        .y = y,
+        .radius = r,
+        .type = type,
+        .last_seen = timer_getMillis(),
+        .confidence = confidence,
+        .id = object_store_next_id++,
+        .variance = OBJ_VARIANCE_DEFAULT,
+    };
+    object_map_c++;
+    object_map_version++;
+
+    object_store_adds++;
+    if (object_map_c > object_store_peak) object_store_peak = object_map_c;
+
+    return object_map_c - 1;
+}
+
+// marks an object as just observed, so lru eviction keeps it
+void touch_object(int index) {
+    object_map[index].last_seen = timer_getMillis();
+}
+
+// prints the store usage
+void object_store_print_stats() {
+    char buff[96];
+    sprintf(buff, "object store - used: %d/%d, peak: %d", object_map_c, OBJECT_MAP_SIZE, object_store_peak);
+    ur_send_line(buff);
+    sprintf(buff, "object store - adds: %u, evictions: %u, dropped: %u", object_store_adds, object_store_evictions, object_store_rejects);
+    ur_send_line(buff);
+}
+
+// ------------------------------ object classification ------------------------------
+// each object keeps the evidence for what it is: how often a scan saw it (and how well the ir and ping agreed and how
+// steady its width was), how often it was bumped into, and how often the cliff sensors found it. object_classify turns
+// that into a type and how sure we are of it. a scanned object that was bumped is definitely tall, an object only ever
+// bumped is short, a cliff hit is a hole. noisy scans (ranges that disagree, widths that jump around) are less sure
+
+#define CLASS_HISTORY 8 // running means weigh about the last this many observations
+#define CLASS_DISAGREE_CM 8 // mean ir/ping disagreement above this and a scanned object is doubtful
+#define CLASS_SURE 192 // class_confidence at or above this is trusted by the planner
+
+// finds the object at or near (x, y), within margin mm of its edge. nearest wins, -1 if none
+int object_find_near(float x, float y, float margin) {
+    int best = -1;
+    float best_d = 0;
+
+    int i;
+    for (i = 0; i < object_map_c; i++) {
+        const float d = dist(object_map[i].x, object_map[i].y, x, y) - object_map[i].radius;
+        if (d <= margin && (best == -1 || d < best_d)) {
+            best = i;
+            best_d = d;
+        }
+    }
+    return best;
+}
+
+// running mean over about CLASS_HISTORY observations, n is the count including this one
+static inline float class_running_mean(float mean, float value, int n) {
+    return mean + (value - mean) / MIN(n, CLASS_HISTORY);
+}
+
+static inline unsigned char class_inc(unsigned char v) {
+    return v < 255 ? v + 1 : v;
+}
+
+// sets type and class_confidence from the evidence
+// only a change in whether it's a sure hazard bumps object_map_version, that's the one part of the class that changes the
+// footprint the planner sees. the rest of the evidence is bookkeeping and would just make every planner cache rebuild
+void object_classify(int index) {
+    object_positional *o = &object_map[index];
+    const char was_sure_hazard = o->type == 2 && o->class_confidence >= CLASS_SURE;
+
+    if (o->cliffs > 0) {
+        o->type = 2;
+        o->class_confidence = MIN(255, 160 + 48 * (o->cliffs - 1));
+    }
+    else if (o->seen > 0) {
+        int c = MIN(255, 64 + 32 * o->seen);
+        if (o->range_disagree > CLASS_DISAGREE_CM) c /= 2;
+        if (o->width_dev * 2 > o->width_mean) c = c * 3 / 4;
+        if (o->bumps > 0) c = MIN(255, c + 96); // something was really there
+
+        o->type = 1;
+        o->class_confidence = c;
+    }
+    else if (o->bumps > 0) {
+        o->type = 0;
+        o->class_confidence = MIN(255, 160 + 48 * (o->bumps - 1));
+    }
+
+    const char sure_hazard = o->type == 2 && o->class_confidence >= CLASS_SURE;
+    if (sure_hazard != was_sure_hazard) object_map_version++;
+}
+
+// adds a scan detection of width mm, where the ir and ping ranges were disagree cm apart
+void object_record_scan(int index, float width, float disagree) {
+    object_positional *o = &object_map[index];
+    o->seen = class_inc(o->seen);
+
+    if (o->seen == 1) {
+        o->width_mean = width;
+        o->width_dev = 0;
+        o->range_disagree = MIN(255, disagree);
+    }
+    else {
+        o->width_dev = class_running_mean(o->width_dev, fabsf(width - o->width_mean), o->seen);
+        o->width_mean = class_running_mean(o->width_mean, width, o->seen);
+        o->range_disagree = MIN(255, class_running_mean(o->range_disagree, disagree, o->seen));
+    }
+
+    object_classify(index);
+}
+
+void object_record_bump(int index) {
+    object_map[index].bumps = class_inc(object_map[index].bumps);
+    object_classify(index);
+}
+
+void object_record_cliff(int index) {
+    object_map[index].cliffs = class_inc(object_map[index].cliffs);
+    object_classify(index);
+}
+
+// a bump at (x, y). adds the evidence to the object there, or a new short object of radius r if there isn't one
+// returns its index, or -1 if it could not be added
+int add_bump_to_map(float x, float y, float r) {
+    int index = object_find_near(x, y, r);
+    if (index == -1) index = add_object_to_map(x, y, r, (char) 0, OBJ_CONFIDENCE_CONTACT);
+    if (index == -1) return -1;
+
+    object_map[index].confidence = OBJ_CONFIDENCE_CONTACT;
+    touch_object(index);
+    object_record_bump(index);
+    return index;
+}
+
+// a hole at (x, y), same as add_bump_to_map for the cliff sensors
+int add_hole_to_map(float x, float y, float r) {
+    int index = object_find_near(x, y, r);
+    if (index == -1 || object_map[index].type != 2) index = add_object_to_map(x, y, r, (char) 2, OBJ_CONFIDENCE_CONTACT);
+    if (index == -1) return -1;
+
+    object_map[index].confidence = OBJ_CONFIDENCE_CONTACT;
+    touch_object(index);
+    object_record_cliff(index);
+    return index;
+}
+
+// scan fusion. new detections are matched to tall objects already on the map and merged in like a small kalman filter
+// (position and radius weighted by variance), instead of the old objects being wiped. tall objects the scan looked at but
+// didn't find lose confidence and are only removed once it runs out, so a single bad scan doesn't make them flicker
+#define OBJ_MEAS_SIGMA_BASE 15.0f // mm, position noise of a scanned object
+#define OBJ_MEAS_SIGMA_PER_MM 0.05f // plus this much per mm of range, mostly from the angle
+#define OBJ_VARIANCE_MIN (5.0f * 5.0f) // never get more sure than this, odometry drifts
+#define OBJ_ASSOC_GATE2 9.0f // squared std devs a detection can be from an object and still match it
+#define OBJ_CONFIDENCE_HIT 32 // gained each time it's seen again
+#define OBJ_CONFIDENCE_MISS 48 // lost each time it's looked at and not seen
+#define OBJ_CONFIDENCE_MIN 40 // removed below this
+
+// take the data from objects array and applies it to object_map using robot relative position
+// detections are fused into matching tall objects, unmatched tall objects in the servo window [start_angle, end_angle] that was scanned fade out
+// reused marks the angles of the window that came from the scan cache (see scan_cache_sweep), nothing was looked at there
+// this time so nothing in them fades
+void update_object_map(int start_angle, int end_angle, const char * reused) {
+    char matched[OBJECT_MAP_SIZE] = {0};
+
+    float det_x[sizeof(objects) / sizeof(objects[0])];
+    float det_y[sizeof(objects) / sizeof(objects[0])];
+    float det_r[sizeof(objects) / sizeof(objects[0])];
+    float det_var[sizeof(objects) / sizeof(objects[0])];
+    float det_disagree[sizeof(objects) / sizeof(objects[0])];
+
+    int i, j;
+
+    // the newly scanned objects in world space
+    for (i = 0; i < objects_c; i++) {
+        const float range = (objects[i].distance + objects[i].size / 2.0f) * 10;
+
+        // object rel pos
+        float tx = range * cosf((objects[i].angle - 90 + get_pos_r()) * (M_PI / 180));
+        float ty = range * sinf((objects[i].angle - 90 + get_pos_r()) * (M_PI / 180));
+
+        // scanner offset
+        tx += 90 * cosf(get_pos_r() * (M_PI / 180));
+        ty += 90 * sinf(get_pos_r() * (M_PI / 180));
+
+        const float sigma = OBJ_MEAS_SIGMA_BASE + OBJ_MEAS_SIGMA_PER_MM * range;
+
+        det_x[i] = get_pos_x() + tx;
+        det_y[i] = get_pos_y() + ty;
+        det_r[i] = objects[i].size * 10 / 2;
+        det_var[i] = sigma * sigma;
+
+        // the object's range came from the ping (or fused), data is still the plain ir
+        const int n = (objects[i].angle - SWEEP_ANGLE_COMP) / SCAN_RESOLUTION;
+        det_disagree[i] = (n >= 0 && n < SCAN_BUFFER_SIZE) ? fabsf(data[n] - objects[i].distance) : 0;
+    }
+
+    // match each detection to the closest (by std devs) tall object in its gate, one detection per object
+    char det_matched[sizeof(objects) / sizeof(objects[0])] = {0};
+    for (i = 0; i < objects_c; i++) {
+        int best = -1;
+        float best_score = FLT_MAX;
+
+        for (j = 0; j < object_map_c; j++) {
+            const object_positional *o = &object_map[j];
+            if (o->type != 1 || matched[j]) continue;
+
+            const float d2 = dist2(o->x, o->y, det_x[i], det_y[i]);
+            const float score = d2 / (o->variance + det_var[i]);
+
+            // a candidate is in the gate, or the detection is centered inside it (always the same object). the closest
+            // candidate wins either way, so an inside match can't take the detection from a closer one in the gate
+            if (score > OBJ_ASSOC_GATE2 && d2 >= o->radius * o->radius) continue;
+            if (score < best_score) {
+                best = j;
+                best_score = score;
+            }
+        }
+
+        if (best == -1) continue;
+
+        // kalman update, the gain is how much of the new measurement to trust
+        object_positional *o = &object_map[best];
+        const float k = o->variance / (o->variance + det_var[i]);
+
+        o->x += k * (det_x[i] - o->x);
+        o->y += k * (det_y[i] - o->y);
+        o->radius += k * (det_r[i] - o->radius);
+        o->variance = (1 - k) * o->variance;
+        if (o->variance < OBJ_VARIANCE_MIN) o->variance = OBJ_VARIANCE_MIN;
+
+        o->confidence = (o->confidence > 255 - OBJ_CONFIDENCE_HIT) ? 255 : o->confidence + OBJ_CONFIDENCE_HIT;
+        touch_object(best);
+        object_record_scan(best, det_r[i] * 2, det_disagree[i]);
+
+        matched[best] = 1;
+        det_matched[i] = 1;
+        object_map_version++;
+    }
+
+    // fade out the tall objects that were looked at and not seen
+    for (i = 0; i < object_map_c; i++) {
+        if (object_map[i].type != 1 || matched[i]) continue;
+
+        // basic info about the object
+        const float dy = object_map[i].y - get_pos_y();
+        const float dx = object_map[i].x - get_pos_x();
+
+        const float dist_bearing = sqrtf(dx*dx + dy*dy);
+
+        // calculate bearing and distance from robot
+        float angle_bearing = atan2f(dy, dx) * (180 / M_PI) - get_pos_r();
+
+        // find how "in front" it is
+        float relative_x = cosf(angle_bearing * (M_PI / 180)) * dist_bearing;
+
+        // and if the scan window actually looked at it
+        while (angle_bearing > 180)   angle_bearing -= 360;
+        while (angle_bearing <= -180) angle_bearing += 360;
+        const float servo_angle = angle_bearing + 90;
+        const char in_window = servo_angle >= start_angle && servo_angle <= end_angle && !reused[(int) roundf(servo_angle) / SCAN_RESOLUTION];
+
+        // objects the bot is sitting on can't be there. otherwise only ones "in front", ie positive x, plus a bit of margin, up to a radial distance
+        char remove = dist_bearing < 150;
+        if (!remove && in_window && dist_bearing <= (SCAN_MAX_DISTANCE * 10) && (relative_x - object_map[i].radius > 50)) {
+            if (object_map[i].confidence < OBJ_CONFIDENCE_MIN + OBJ_CONFIDENCE_MISS) remove = 1;
+            else object_map[i].confidence -= OBJ_CONFIDENCE_MISS;
+        }
+
+        if (remove) {
+            matched[i] = matched[object_map_c - 1]; // follows the object swapped in
+            remove_object_from_map(i);
+            i--;
+        }
+    }
+
+    // add the detections that are new objects
+    for (i = 0; i < objects_c; i++) {
+        if (det_matched[i]) continue;
+
+        const int index = add_object_to_map(det_x[i], det_y[i], det_r[i], (char) 1, OBJ_CONFIDENCE_SCAN);
+        if (index != -1) {
+            object_map[index].variance = det_var[i];
+            object_record_scan(index, det_r[i] * 2, det_disagree[i]);
+        }
+    }
+}
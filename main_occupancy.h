@@ -0,0 +1,287 @@
+#pragma once
+
+#include "main_scan_data.h"
+#include "scan.h"
+#include "movement.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+
+
+// ------------------------------ occupancy grid ------------------------------
+// a 48 by 48 grid of 75mm cells (3.6m square, the same span as the grid planner's window) that follows the bot around,
+// each cell an 8 bit log-odds of being occupied
+// sweeps carve free space along every beam and mark where the beam ended. bumps and cliffs are pinned as occupied for good
+// pathfinding checks it on top of object_map through a 1 bit per cell inflated layer, so a point check is a single lookup
+// 2.3KB of log-odds plus 384 bytes of bits
+
+#define OCC_SIZE 48 // at most 64, a row of the inflated layer is one uint64_t
+#define OCC_CELL 75.0f // mm
+#define OCC_RECENTER 8 // cells the bot can wander from the center before the grid scrolls
+
+#define OCC_HIT 20 // added where a beam ends
+#define OCC_MISS 6 // taken from every cell a beam passes through
+#define OCC_MIN (-60)
+#define OCC_PINNED 127 // bumps and cliffs, sweeps never change these
+#define OCC_OCCUPIED 40 // log-odds above this is an obstacle
+
+#define OCC_INFLATE_MM 190.0f // BOT_RADIUS + CLEARANCE_TOLERANCE in main_pathfinding.h
+#define OCC_INFLATE_CELLS 2 // OCC_INFLATE_MM / OCC_CELL rounded down
+#define OCC_IGNORE_NEAR_MM 160.0f // BOT_RADIUS, the bot's own footprint is never blocked
+#define OCC_SCANNER_OFFSET 90.0f // mm the scanner sits in front of the bot center
+
+// 1 to have is_point_free and segment_clear check the grid too
+#define OCC_PLANNING 1
+
+static int8_t occ_grid[OCC_SIZE][OCC_SIZE]; // [y][x]
+static uint64_t occ_inflated[OCC_SIZE]; // bit x of row y is set if that cell is within OCC_INFLATE_MM of an occupied one
+static char occ_inflated_dirty = 0;
+unsigned int occ_version = 0; // bumped whenever the grid is edited, like object_map_version
+
+// world cell of grid (0, 0)
+static int occ_origin_x = -OCC_SIZE / 2;
+static int occ_origin_y = -OCC_SIZE / 2;
+
+static inline int occ_world_cell(float v) {
+    return (int) floorf(v / OCC_CELL);
+}
+
+// forget everything and center on the bot
+void occ_clear() {
+    memset(occ_grid, 0, sizeof(occ_grid));
+    memset(occ_inflated, 0, sizeof(occ_inflated));
+    occ_inflated_dirty = 0;
+    occ_version++;
+
+    occ_origin_x = occ_world_cell(get_pos_x()) - OCC_SIZE / 2;
+    occ_origin_y = occ_world_cell(get_pos_y()) - OCC_SIZE / 2;
+}
+
+// scrolls the grid by (dx, dy) cells, what scrolls in is unknown
+static void occ_shift(int dx, int dy) {
+    if (abs(dx) >= OCC_SIZE || abs(dy) >= OCC_SIZE) {
+        memset(occ_grid, 0, sizeof(occ_grid));
+    }
+    else {
+        int y;
+        if (dy > 0) {
+            memmove(occ_grid[0], occ_grid[dy], (OCC_SIZE - dy) * OCC_SIZE);
+            memset(occ_grid[OCC_SIZE - dy], 0, dy * OCC_SIZE);
+        }
+        else if (dy < 0) {
+            memmove(occ_grid[-dy], occ_grid[0], (OCC_SIZE + dy) * OCC_SIZE);
+            memset(occ_grid[0], 0, -dy * OCC_SIZE);
+        }
+
+        for (y = 0; y < OCC_SIZE && dx != 0; y++) {
+            if (dx > 0) {
+                memmove(&occ_grid[y][0], &occ_grid[y][dx], OCC_SIZE - dx);
+                memset(&occ_grid[y][OCC_SIZE - dx], 0, dx);
+            }
+            else {
+                memmove(&occ_grid[y][-dx], &occ_grid[y][0], OCC_SIZE + dx);
+                memset(&occ_grid[y][0], 0, -dx);
+            }
+        }
+    }
+
+    occ_origin_x += dx;
+    occ_origin_y += dy;
+    occ_inflated_dirty = 1;
+    occ_version++;
+}
+
+// scrolls the grid if the bot wandered too far from the middle
+static void occ_follow_bot() {
+    const int dx = occ_world_cell(get_pos_x()) - (occ_origin_x + OCC_SIZE / 2);
+    const int dy = occ_world_cell(get_pos_y()) - (occ_origin_y + OCC_SIZE / 2);
+
+    if (abs(dx) > OCC_RECENTER || abs(dy) > OCC_RECENTER) occ_shift(dx, dy);
+}
+
+// adds delta to a grid cell, clamped. pinned cells are left alone
+static inline void occ_add(int gx, int gy, int delta) {
+    if (gx < 0 || gx >= OCC_SIZE || gy < 0 || gy >= OCC_SIZE) return;
+
+    int v = occ_grid[gy][gx];
+    if (v == OCC_PINNED) return;
+
+    v += delta;
+    if (v < OCC_MIN) v = OCC_MIN;
+    if (v > OCC_PINNED - 1) v = OCC_PINNED - 1;
+    occ_grid[gy][gx] = v;
+}
+
+static inline void occ_pin(int gx, int gy) {
+    if (gx < 0 || gx >= OCC_SIZE || gy < 0 || gy >= OCC_SIZE) return;
+    occ_grid[gy][gx] = OCC_PINNED;
+}
+
+// one beam from (ax, ay) to (bx, by) in world mm. every cell on the way is more likely free, the last one more likely occupied if hit
+static void occ_ray(float ax, float ay, float bx, float by, char hit) {
+    int x0 = occ_world_cell(ax) - occ_origin_x;
+    int y0 = occ_world_cell(ay) - occ_origin_y;
+    const int x1 = occ_world_cell(bx) - occ_origin_x;
+    const int y1 = occ_world_cell(by) - occ_origin_y;
+
+    // bresenham
+    const int dx = abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+    const int dy = -abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
+    int err = dx + dy;
+
+    while (x0 != x1 || y0 != y1) {
+        occ_add(x0, y0, -OCC_MISS);
+
+        const int e2 = 2 * err;
+        if (e2 >= dy) { err += dy; x0 += sx; }
+        if (e2 <= dx) { err += dx; y0 += sy; }
+    }
+
+    occ_add(x1, y1, hit ? OCC_HIT : -OCC_MISS);
+}
+
+// updates the grid from a sweep (cm, indexed by servo angle / SCAN_RESOLUTION) over the servo window [start_angle, end_angle]
+// taken from the current pose. readings past SCAN_MAX_DISTANCE only carve free space out to that distance
+void occ_update_from_sweep(float * ranges, int start_angle, int end_angle) {
+    occ_follow_bot();
+
+    const float r = get_pos_r() * (M_PI / 180);
+    const float sx = get_pos_x() + OCC_SCANNER_OFFSET * cosf(r);
+    const float sy = get_pos_y() + OCC_SCANNER_OFFSET * sinf(r);
+
+    int s;
+    for (s = start_angle; s <= end_angle; s += SCAN_RESOLUTION) {
+        const float range = ranges[s / SCAN_RESOLUTION];
+        if (range <= 0 || range >= SCAN_NO_DATA) continue;
+
+        const char hit = range <= SCAN_MAX_DISTANCE;
+        const float range_mm = (hit ? range : SCAN_MAX_DISTANCE) * 10;
+        const float angle = r + (s + SWEEP_ANGLE_COMP - 90) * (M_PI / 180);
+
+        occ_ray(sx, sy, sx + range_mm * cosf(angle), sy + range_mm * sinf(angle), hit);
+    }
+
+    occ_inflated_dirty = 1;
+    occ_version++;
+}
+
+// pins every cell in the circle at (x, y) of radius r mm as occupied, for bumps and holes
+void occ_mark_disc(float x, float y, float r) {
+    occ_follow_bot();
+
+    const int x0 = occ_world_cell(x - r) - occ_origin_x;
+    const int x1 = occ_world_cell(x + r) - occ_origin_x;
+    const int y0 = occ_world_cell(y - r) - occ_origin_y;
+    const int y1 = occ_world_cell(y + r) - occ_origin_y;
+
+    int gx, gy;
+    for (gy = y0; gy <= y1; gy++) {
+        for (gx = x0; gx <= x1; gx++) {
+            // cell center
+            const float cx = (gx + occ_origin_x + 0.5f) * OCC_CELL;
+            const float cy = (gy + occ_origin_y + 0.5f) * OCC_CELL;
+            if (dist2(cx, cy, x, y) <= r * r) occ_pin(gx, gy);
+        }
+    }
+
+    occ_inflated_dirty = 1;
+    occ_version++;
+}
+
+// pins every cell along the line from (ax, ay) to (bx, by) as occupied, for the white border
+void occ_mark_segment(float ax, float ay, float bx, float by) {
+    occ_follow_bot();
+
+    const float len = dist(ax, ay, bx, by);
+    const int steps = (int) (len / (OCC_CELL / 2)) + 1;
+
+    int i;
+    for (i = 0; i <= steps; i++) {
+        const float t = (float) i / steps;
+        occ_pin(occ_world_cell(ax + t * (bx - ax)) - occ_origin_x, occ_world_cell(ay + t * (by - ay)) - occ_origin_y);
+    }
+
+    occ_inflated_dirty = 1;
+    occ_version++;
+}
+
+// grows every occupied cell by OCC_INFLATE_MM into the bit layer, a row of a disc at a time
+static void occ_rebuild_inflated() {
+    const int reach = OCC_INFLATE_CELLS;
+    const float reach2 = (OCC_INFLATE_MM / OCC_CELL) * (OCC_INFLATE_MM / OCC_CELL);
+
+    // half width of the disc on each row offset
+    int half[2 * OCC_INFLATE_CELLS + 1];
+    int dy;
+    for (dy = -reach; dy <= reach; dy++) half[dy + reach] = (int) sqrtf(reach2 - dy * dy);
+
+    memset(occ_inflated, 0, sizeof(occ_inflated));
+
+    int gx, gy;
+    for (gy = 0; gy < OCC_SIZE; gy++) {
+        for (gx = 0; gx < OCC_SIZE; gx++) {
+            if (occ_grid[gy][gx] <= OCC_OCCUPIED) continue;
+
+            for (dy = -reach; dy <= reach; dy++) {
+                const int row = gy + dy;
+                if (row < 0 || row >= OCC_SIZE) continue;
+
+                // bits gx - w to gx + w, anything off the edge is shifted out
+                const int w = half[dy + reach];
+                const uint64_t mask = (((uint64_t) 1) << (2 * w + 1)) - 1;
+                occ_inflated[row] |= (gx >= w) ? (mask << (gx - w)) : (mask >> (w - gx));
+            }
+        }
+    }
+
+    occ_inflated_dirty = 0;
+}
+
+// 1 if the grid cell is inflated. off the grid is unknown, which counts as free
+static inline char occ_cell_blocked(int gx, int gy) {
+    if (gx < 0 || gx >= OCC_SIZE || gy < 0 || gy >= OCC_SIZE) return 0;
+    return (occ_inflated[gy] >> gx) & 1;
+}
+
+// 1 if the bot can't be at (px, py) according to the grid
+static char occ_point_blocked(float px, float py) {
+    if (occ_inflated_dirty) occ_rebuild_inflated();
+    if (dist2(px, py, get_pos_x(), get_pos_y()) < OCC_IGNORE_NEAR_MM * OCC_IGNORE_NEAR_MM) return 0;
+
+    return occ_cell_blocked(occ_world_cell(px) - occ_origin_x, occ_world_cell(py) - occ_origin_y);
+}
+
+// 1 if the bot can't drive from (ax, ay) to (bx, by) according to the grid
+static char occ_segment_blocked(float ax, float ay, float bx, float by) {
+    if (occ_inflated_dirty) occ_rebuild_inflated();
+
+    int x0 = occ_world_cell(ax) - occ_origin_x;
+    int y0 = occ_world_cell(ay) - occ_origin_y;
+    const int x1 = occ_world_cell(bx) - occ_origin_x;
+    const int y1 = occ_world_cell(by) - occ_origin_y;
+
+    const float near2 = (OCC_IGNORE_NEAR_MM / OCC_CELL) * (OCC_IGNORE_NEAR_MM / OCC_CELL);
+    const float bot_gx = get_pos_x() / OCC_CELL - occ_origin_x - 0.5f;
+    const float bot_gy = get_pos_y() / OCC_CELL - occ_origin_y - 0.5f;
+
+    // bresenham
+    const int dx = abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+    const int dy = -abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
+    int err = dx + dy;
+
+    for (;;) {
+        const float nx = x0 - bot_gx;
+        const float ny = y0 - bot_gy;
+        if (nx * nx + ny * ny >= near2 && occ_cell_blocked(x0, y0)) return 1;
+
+        if (x0 == x1 && y0 == y1) break;
+
+        const int e2 = 2 * err;
+        if (e2 >= dy) { err += dy; x0 += sx; }
+        if (e2 <= dx) { err += dx; y0 += sy; }
+    }
+
+    return 0;
+}
@@ -1,498 +1,1456 @@
-
-#include "main_scan_data.h"
-#include "rng.h"
-
-#include <math.h>
-#include <stdint.h>
-
-
-
-
-
-
-
-// ------------------------------ exploratory heat map ------------------------------
-// this is a 16 by 16 grid mapped to a 5m by 5m square, starting at (0, 0). each contains a 4 bit value
-// each point is 333.333333mm spaced in a grid, starting at center. if a new found point goes outside the grid (it only ever should in the neg direction), it will adjust itself
-// this allows for travel in one direction of about 5m
-// the y direction is represented by the array, where positive is up
-// the x direction is represented by each 64 bit number, divided into 16 chunks of 4 bits each
-// only 128 bytes!
-
-#define EXP_MAP_SPACING 333.3333333f // space between each point
-
-static uint64_t exploratory_map[16];
-int8_t y_offset = 0;
-int8_t x_offset = 0;
-
-#define exp_map_val_at(x, y) ((unsigned int) ((exploratory_map[y] >> (4 * x)) & 0b1111))
-
-static inline void exp_map_set_at(unsigned int x, unsigned int y, unsigned int value) {
-    exploratory_map[y] = (exploratory_map[y] & ~(((uint64_t) 0b1111) << (4 * x))) | (((uint64_t) (value & 0b1111)) << (4 * x));
-}
-
-static void exp_map_shift_left() {
-    x_offset--;
-    int y;
-    for (y = 0; y < 16; y++) {
-        exploratory_map[y] = exploratory_map[y] >> 4;
-    }
-}
-static void exp_map_shift_down() {
-    y_offset--;
-    int y;
-    for (y = 0; y < 15; y++) {
-        exploratory_map[y] = exploratory_map[y+1];
-    }
-    exploratory_map[15] = 0;
-}
-static void exp_map_dec_all() {
-    int x, y;
-    for (x = 0; x < 16; x++) {
-        for (y = 0; y < 16; y++) {
-            int map_val = exp_map_val_at(x, y);
-            if (map_val > 0) map_val--;
-            exp_map_set_at(x, y, map_val);
-        }
-    }
-}
-
-// increase the nearest weight on the map by 1 given the robot's position
-static inline void exp_map_new_searched_point(float sx, float sy) {
-    // shift the map as needed
-    while (sx < x_offset * EXP_MAP_SPACING) {
-        exp_map_shift_left();
-    }
-    while (sy < y_offset * EXP_MAP_SPACING) {
-        exp_map_shift_down();
-    }
-
-    // from global to map
-    const int gx = roundf((sx - (x_offset * EXP_MAP_SPACING)) / EXP_MAP_SPACING);
-    const int gy = roundf((sy - (y_offset * EXP_MAP_SPACING)) / EXP_MAP_SPACING);
-
-    if (gx < 0 || gx > 15 || gy < 0 || gy > 15) ur_send_line("exp_map_new_searched_point out of bounds error");
-
-    int map_val = exp_map_val_at(gx, gy);
-    if (map_val >= 0b1111) {
-        exp_map_dec_all();
-        map_val--;
-    }
-    exp_map_set_at(gx, gy, map_val + 1);
-}
-
-// get a weighted point on the map from bot position
-static inline unsigned int exp_map_get_weighted_point(float sx, float sy) {
-    const int gx = roundf((sx - (x_offset * EXP_MAP_SPACING)) / EXP_MAP_SPACING);
-    const int gy = roundf((sy - (y_offset * EXP_MAP_SPACING)) / EXP_MAP_SPACING);
-
-    if (gx < 0 || gx > 15 || gy < 0 || gy > 15) ur_send_line("exp_map_get_weighted_point out of bounds error");
-
-    return exp_map_val_at(gx, gy);
-}
-
-// get a weighted point on the map from bot position, ensures safe out-of-bounds behavior
-static inline unsigned int exp_map_get_weighted_point_safe(float sx, float sy) {
-    const int gx = roundf((sx - (x_offset * EXP_MAP_SPACING)) / EXP_MAP_SPACING);
-    const int gy = roundf((sy - (y_offset * EXP_MAP_SPACING)) / EXP_MAP_SPACING);
-
-    if (gx < 0 || gx > 15 || gy < 0 || gy > 15) {
-        return roundf(exp_rand_range(0, 3)); // generally bias to outside the map, this will help us find walls faster
-    }
-
-    return exp_map_val_at(gx, gy);
-}
-
-
-
-// ------------------------------ pathfinding helpers ------------------------------
-// the radius of the bot and the space between objects we want to maintain, accounting for error in some cases
-#define BOT_RADIUS 160
-#define CLEARANCE_TOLERANCE 30
-
-// returns if the object at index is brushed up against an object, defined as dist < BOT_RADIUS + CLEARANCE_TOLERANCE
-static inline char is_object_brushing_bot(int index) {
-    const object_positional *o = &object_map[index];
-    const float distance = dist(o->x, o->y, get_pos_x(), get_pos_y());
-    return distance < BOT_RADIUS + CLEARANCE_TOLERANCE;
-}
-
-// returns 1 if point (px,py) is in free space (not colliding with any inflated object)
-static char is_point_free(float px, float py) {
-    int i;
-    for (i = 0; i < object_map_c; ++i) {
-        const object_positional *o = &object_map[i];
-
-        // duplicated on segment_clear, we do not consider the tolerance when too nearby an object for the sake of pathfinding
-        float r = o->radius + BOT_RADIUS + (is_object_brushing_bot(i) ? 0 : CLEARANCE_TOLERANCE);
-
-        float dx = px - o->x;
-        float dy = py - o->y;
-        float d2 = dx * dx + dy * dy;
-
-        if (d2 <= r * r) {
-            // Inside or touching inflated obstacle
-            return 0;
-        }
-    }
-    return 1;
-}
-
-// returns 1 if segment AB is collision-free against all inflated objects
-static char segment_clear(float ax, float ay, float bx, float by) {
-    int i;
-    float dx = bx - ax;
-    float dy = by - ay;
-    float seg_len2 = dx * dx + dy * dy;
-
-    if (seg_len2 == 0.0f) {
-        // Degenerate segment, just test the point.
-        return is_point_free(ax, ay);
-    }
-
-    for (i = 0; i < object_map_c; ++i) {
-        const object_positional *o = &object_map[i];
-
-        float r = o->radius + BOT_RADIUS + (is_object_brushing_bot(i) ? 0 : CLEARANCE_TOLERANCE);
-
-        // Vector from circle center to segment start
-        float fx = ax - o->x;
-        float fy = ay - o->y;
-
-        // Project center onto segment (parameter t in [0,1])
-        float t = -(fx * dx + fy * dy) / seg_len2;
-        if (t < 0.0f) t = 0.0f;
-        else if (t > 1.0f) t = 1.0f;
-
-        float closest_x = ax + t * dx;
-        float closest_y = ay + t * dy;
-
-        float cx = closest_x - o->x;
-        float cy = closest_y - o->y;
-        float dist2 = cx * cx + cy * cy;
-
-        if (dist2 <= r * r) {
-            // The path comes within clearance of this obstacle
-            return 0;
-        }
-    }
-
-    return 1;
-}
-
-
-// ------------------------------ random point selection ------------------------------
-#define GLOBAL_HALF_SIZE_MM 5000.0f
-#define GLOBAL_MIN_MM (-GLOBAL_HALF_SIZE_MM)
-#define GLOBAL_MAX_MM ( GLOBAL_HALF_SIZE_MM)
-
-typedef struct SamplePoint {
-    int16_t x, y;
-} SamplePoint;
-
-#define SAMPLE_POINT_CNT 64
-
-// selects a random valid xy point -5000 to 5000, prioritizes low values in the exp_map (ie, lesser explored points)
-static void exp_map_pick_random_point(float * ox, float * oy) {
-    // generate a set of random points to try, should all be not inside of obstacle
-    SamplePoint sample_points[SAMPLE_POINT_CNT];
-    int i;
-    for (i = 0; i < SAMPLE_POINT_CNT; i++) {
-        do {
-            sample_points[i].x = roundf(exp_rand_range(-5000, 5000));
-            sample_points[i].y = roundf(exp_rand_range(-5000, 5000));
-        } while (!is_point_free(sample_points[i].x, sample_points[i].y));
-    }
-
-
-    // find the lowest sample point
-    unsigned int lowest_index = 0;
-    unsigned int lowest_value = exp_map_get_weighted_point_safe(sample_points[0].x, sample_points[0].y);
-
-    for (i = 1; i < SAMPLE_POINT_CNT; i++) {
-        unsigned int value = exp_map_get_weighted_point_safe(sample_points[i].x, sample_points[i].y);
-
-        if (value < lowest_value) {
-            lowest_index = i;
-            lowest_value = value;
-        }
-    }
-
-    *ox = sample_points[lowest_index].x;
-    *oy = sample_points[lowest_index].y;
-}
-
-
-
-
-
-// ------------------------------ main pathfinding algorithm ------------------------------
-#define MAX_CANDIDATES 64
-#define DUPLICATE_EPS2 (25.0f)   // 5 mm squared
-
-
-
-// Add a candidate waypoint if it's free and not (almost) duplicate.
-static void add_candidate(float x, float y, float *cand_x, float *cand_y, int *cand_count) {
-    int i;
-
-    if (*cand_count >= MAX_CANDIDATES) {
-        ur_send_line("MAX_CANDIDATES overflow in add_candidate");
-        return;
-    }
-
-    if (!is_point_free(x, y)) {
-        return;
-    }
-
-    for (i = 0; i < *cand_count; ++i) {
-        float dx = x - cand_x[i];
-        float dy = y - cand_y[i];
-        if (dx * dx + dy * dy < DUPLICATE_EPS2) {
-            return;
-        }
-    }
-
-    cand_x[*cand_count] = x;
-    cand_y[*cand_count] = y;
-    (*cand_count)++;
-}
-
-// S - W1 - W2 - E path finding algorithm based off of candidate points around objects
-// ox, oy are return values
-// returns sx, sy if no valid path found
-// returns tx, ty if the valid path is completely clear
-// returns W1 (the first waypoint to go to in the path) otherwise
-void path_to(float sx, float sy, float tx, float ty, float *ox, float *oy) {
-    int i;
-    float cand_x[MAX_CANDIDATES];
-    float cand_y[MAX_CANDIDATES];
-    int   cand_count = 0;
-
-    const float BIG = 1.0e30f;
-
-    // 0. Safety: start/target must be in free space, otherwise fail.
-    if (!is_point_free(sx, sy) || !is_point_free(tx, ty)) {
-        *ox = sx;
-        *oy = sy;
-        return;
-    }
-
-    // 1. If direct segment is clear, go straight to target.
-    if (segment_clear(sx, sy, tx, ty)) {
-        *ox = tx;
-        *oy = ty;
-        return;
-    }
-
-    // 2. Build diversion waypoints around obstacles that block S->T.
-    {
-        float dx = tx - sx;
-        float dy = ty - sy;
-        float L2 = dx * dx + dy * dy;
-
-        if (L2 == 0.0f) {
-            *ox = sx;
-            *oy = sy;
-            return;
-        }
-
-        float L  = sqrtf(L2);
-        float ux = dx / L;
-        float uy = dy / L;
-        // Perpendicular to path (unit)
-        float nx = -uy;
-        float ny =  ux;
-
-        // Cluster info for blocking obstacles (for "walls")
-        int   blocker_count   = 0;
-        float min_t           = 0.0f;
-        float max_t           = 0.0f;
-        float max_abs_perp    = 0.0f;
-        float max_r_inflated  = 0.0f;
-
-        for (i = 0; i < object_map_c; ++i) {
-            object_positional *o = &object_map[i];
-            float r_inflated = o->radius + BOT_RADIUS + CLEARANCE_TOLERANCE;
-
-            // Vector from S to obstacle center
-            float wx = o->x - sx;
-            float wy = o->y - sy;
-
-            // Longitudinal coordinate along S->T
-            float t = wx * ux + wy * uy;
-
-            // Ignore obstacles far behind start or far beyond target
-            if (t < -r_inflated || t > L + r_inflated)
-                continue;
-
-            // Signed perpendicular distance to S->T
-            float d_perp_signed = wx * nx + wy * ny;
-            float d2_perp       = d_perp_signed * d_perp_signed;
-
-            // If outside inflated corridor, doesn't block
-            if (d2_perp >= r_inflated * r_inflated)
-                continue;
-
-            // === This obstacle blocks the corridor ===
-            if (blocker_count == 0) {
-                min_t = max_t = t;
-            } else {
-                if (t < min_t) min_t = t;
-                if (t > max_t) max_t = t;
-            }
-            blocker_count++;
-            if (fabsf(d_perp_signed) > max_abs_perp)
-                max_abs_perp = fabsf(d_perp_signed);
-            if (r_inflated > max_r_inflated)
-                max_r_inflated = r_inflated;
-
-            // --- Local waypoints around this obstacle ---
-
-            // Side offset (perpendicular)
-            const float SIDE_OFFSET_SCALE_LOCAL = 1.05f;   // hug closer
-            float side_offset = r_inflated * SIDE_OFFSET_SCALE_LOCAL;
-            float min_side_offset = r_inflated + 2.0f;     // small safety
-            if (side_offset < min_side_offset) side_offset = min_side_offset;
-
-            // Forward/back offset along the path for 2-node wrapping
-            const float FORWARD_SCALE = 0.7f;
-            float f_offset = r_inflated * FORWARD_SCALE;
-
-            int sgn;
-            for (sgn = -1; sgn <= 1; sgn += 2) {
-                // Base side point (left/right of obstacle)
-                float base_x = o->x + nx * (sgn * side_offset);
-                float base_y = o->y + ny * (sgn * side_offset);
-
-                // Pure side-step candidate
-                add_candidate(base_x, base_y, cand_x, cand_y, &cand_count);
-
-                // Backward along path
-                add_candidate(base_x - ux * f_offset,
-                              base_y - uy * f_offset,
-                              cand_x, cand_y, &cand_count);
-
-                // Forward along path
-                add_candidate(base_x + ux * f_offset,
-                              base_y + uy * f_offset,
-                              cand_x, cand_y, &cand_count);
-            }
-        }
-
-        // Cluster-level "far" waypoints to go around a whole wall,
-        // but only if there is more than one blocking obstacle.
-        if (blocker_count > 1 && max_r_inflated > 0.0f) {
-            float t_mid = 0.5f * (min_t + max_t);
-            if (t_mid < 0.0f) t_mid = 0.0f;
-            if (t_mid > L)    t_mid = L;
-
-            float base_x = sx + ux * t_mid;
-            float base_y = sy + uy * t_mid;
-
-            const float SIDE_OFFSET_SCALE_CLUSTER = 1.8f; // smaller than before
-            float offset = max_abs_perp +
-                           SIDE_OFFSET_SCALE_CLUSTER * max_r_inflated +
-                           CLEARANCE_TOLERANCE;
-
-            if (offset < max_r_inflated + CLEARANCE_TOLERANCE)
-                offset = max_r_inflated + CLEARANCE_TOLERANCE;
-
-            // Above / one side
-            add_candidate(base_x + nx * offset,
-                          base_y + ny * offset,
-                          cand_x, cand_y, &cand_count);
-
-            // Below / other side
-            add_candidate(base_x - nx * offset,
-                          base_y - ny * offset,
-                          cand_x, cand_y, &cand_count);
-        }
-    }
-
-    if (cand_count == 0) {
-        // No diversion points found, fail.
-        *ox = sx;
-        *oy = sy;
-        return;
-    }
-
-    // 3. Try all 2-node paths: S -> W1 -> W2 -> T (preferred).
-    {
-        float best_cost = BIG;
-        float best_x = sx;
-        float best_y = sy;
-        int i1, i2;
-
-        for (i1 = 0; i1 < cand_count; ++i1) {
-            float w1x = cand_x[i1];
-            float w1y = cand_y[i1];
-
-            if (!segment_clear(sx, sy, w1x, w1y)) continue;
-
-            for (i2 = 0; i2 < cand_count; ++i2) {
-                float w2x, w2y;
-                float cost;
-
-                if (i2 == i1) continue;
-
-                w2x = cand_x[i2];
-                w2y = cand_y[i2];
-
-                if (!segment_clear(w1x, w1y, w2x, w2y)) continue;
-                if (!segment_clear(w2x, w2y, tx, ty)) continue;
-
-                cost  = dist(sx, sy, w1x, w1y);
-                cost += dist(w1x, w1y, w2x, w2y);
-                cost += dist(w2x, w2y, tx, ty);
-
-                if (cost < best_cost) {
-                    best_cost = cost;
-                    best_x = w1x; // next node is the first waypoint
-                    best_y = w1y;
-                }
-            }
-        }
-
-        if (best_cost < BIG * 0.5f) {
-            *ox = best_x;
-            *oy = best_y;
-            return;
-        }
-    }
-
-    // 4. Fallback: 1-node paths S -> W -> T if 2-node failed.
-    {
-        float best_cost = BIG;
-        float best_x = sx;
-        float best_y = sy;
-        int   k;
-
-        for (k = 0; k < cand_count; ++k) {
-            float wx = cand_x[k];
-            float wy = cand_y[k];
-
-            if (!segment_clear(sx, sy, wx, wy)) continue;
-            if (!segment_clear(wx, wy, tx, ty)) continue;
-
-            {
-                float cost = dist(sx, sy, wx, wy) + dist(wx, wy, tx, ty);
-                if (cost < best_cost) {
-                    best_cost = cost;
-                    best_x = wx;
-                    best_y = wy;
-                }
-            }
-        }
-
-        if (best_cost < BIG * 0.5f) {
-            *ox = best_x;
-            *oy = best_y;
-            return;
-        }
-    }
-
-    // 5. No path found with up to 2 waypoints -> fail (stay put).
-    *ox = sx;
-    *oy = sy;
-}
+
+#include "main_scan_data.h"
+#include "main_occupancy.h"
+#include "main_segments.h"
+#include "rng.h"
+#include "Timer.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+
+
+
+
+
+
+// ------------------------------ exploratory heat map ------------------------------
+// how often the bot has been around each spot, as 4 bit counts. the map is made of 4 by 4 cell tiles, each one a single
+// 64 bit number (cell x, y is the 4 bits at 4 * (y * 4 + x)), kept in small hash tables keyed by tile position so it can
+// grow in any direction. there are two levels: fine cells for near the bot, and coarse cells 4 times bigger that cover
+// everywhere it has been. when the fine table fills up the tile farthest from the bot is dropped, the coarse one still
+// remembers the area. memory is fixed at (EXP_FINE_SLOTS + EXP_COARSE_SLOTS) tiles, under 1KB
+
+#define EXP_MAP_SPACING 333.3333333f // space between each fine cell
+#define EXP_COARSE_SPACING (EXP_MAP_SPACING * EXP_TILE_CELLS) // space between each coarse cell, a whole fine tile
+#define EXP_TILE_CELLS 4 // cells along each side of a tile
+
+#define EXP_FINE_SLOTS 32 // power of 2
+#define EXP_COARSE_SLOTS 16 // power of 2
+#define EXP_MAX_LOAD(slots) ((slots) * 3 / 4) // tiles a table holds before it starts dropping far ones
+
+typedef struct exp_tile {
+    uint64_t cells;
+    int16_t tx, ty; // tile position, in tiles
+    char used;
+} exp_tile;
+
+typedef struct exp_level {
+    exp_tile * tiles;
+    int slots;
+    int count;
+    float spacing;
+} exp_level;
+
+static exp_tile exp_fine_tiles[EXP_FINE_SLOTS];
+static exp_tile exp_coarse_tiles[EXP_COARSE_SLOTS];
+
+static exp_level exp_fine = { exp_fine_tiles, EXP_FINE_SLOTS, 0, EXP_MAP_SPACING };
+static exp_level exp_coarse = { exp_coarse_tiles, EXP_COARSE_SLOTS, 0, EXP_COARSE_SPACING };
+
+#define exp_tile_val_at(t, lx, ly) ((unsigned int) (((t)->cells >> (4 * ((ly) * EXP_TILE_CELLS + (lx)))) & 0b1111))
+
+static inline void exp_tile_set_at(exp_tile * t, unsigned int lx, unsigned int ly, unsigned int value) {
+    const unsigned int shift = 4 * (ly * EXP_TILE_CELLS + lx);
+    t->cells = (t->cells & ~(((uint64_t) 0b1111) << shift)) | (((uint64_t) (value & 0b1111)) << shift);
+}
+
+// floor division by the tile size, plain / rounds negatives the wrong way
+static inline int exp_floor_div(int v) {
+    return v >= 0 ? v / EXP_TILE_CELLS : -((-v + EXP_TILE_CELLS - 1) / EXP_TILE_CELLS);
+}
+
+static inline int exp_tile_home(const exp_level * l, int tx, int ty) {
+    return ((unsigned int) (tx * 73856093) ^ (unsigned int) (ty * 19349663)) & (l->slots - 1);
+}
+
+// the tile at (tx, ty), NULL if it isn't in the table
+static exp_tile * exp_tile_find(exp_level * l, int tx, int ty) {
+    int i = exp_tile_home(l, tx, ty);
+    while (l->tiles[i].used) {
+        if (l->tiles[i].tx == tx && l->tiles[i].ty == ty) return &l->tiles[i];
+        i = (i + 1) & (l->slots - 1);
+    }
+    return NULL;
+}
+
+// removes the tile in slot i, moving back any later tiles in the probe run so lookups don't stop early
+static void exp_tile_remove(exp_level * l, int i) {
+    const int mask = l->slots - 1;
+    int j = i;
+    while (1) {
+        j = (j + 1) & mask;
+        if (!l->tiles[j].used) break;
+
+        // j can fill the hole if its home isn't cyclically in (i, j]
+        const int k = exp_tile_home(l, l->tiles[j].tx, l->tiles[j].ty);
+        if ((j > i && (k <= i || k > j)) || (j < i && k <= i && k > j)) {
+            l->tiles[i] = l->tiles[j];
+            i = j;
+        }
+    }
+    l->tiles[i].used = 0;
+    l->count--;
+}
+
+// the tile at (tx, ty), added if needed. drops the tile farthest from the bot if the table is full
+static exp_tile * exp_tile_get(exp_level * l, int tx, int ty) {
+    exp_tile * t = exp_tile_find(l, tx, ty);
+    if (t) return t;
+
+    if (l->count >= EXP_MAX_LOAD(l->slots)) {
+        const float tile_size = l->spacing * EXP_TILE_CELLS;
+        int far = -1;
+        float far_d2 = -1;
+
+        int i;
+        for (i = 0; i < l->slots; i++) {
+            if (!l->tiles[i].used) continue;
+            const float dx = (l->tiles[i].tx + 0.5f) * tile_size - get_pos_x();
+            const float dy = (l->tiles[i].ty + 0.5f) * tile_size - get_pos_y();
+            if (dx * dx + dy * dy > far_d2) {
+                far = i;
+                far_d2 = dx * dx + dy * dy;
+            }
+        }
+        exp_tile_remove(l, far);
+    }
+
+    int i = exp_tile_home(l, tx, ty);
+    while (l->tiles[i].used) i = (i + 1) & (l->slots - 1);
+
+    l->tiles[i] = (exp_tile) { 0, tx, ty, 1 };
+    l->count++;
+    return &l->tiles[i];
+}
+
+// global position to the tile and cell inside it
+static inline void exp_locate(const exp_level * l, float sx, float sy, int * tx, int * ty, int * lx, int * ly) {
+    const int cx = roundf(sx / l->spacing);
+    const int cy = roundf(sy / l->spacing);
+    *tx = exp_floor_div(cx);
+    *ty = exp_floor_div(cy);
+    *lx = cx - *tx * EXP_TILE_CELLS;
+    *ly = cy - *ty * EXP_TILE_CELLS;
+}
+
+// word parallel (swar) ops on a whole tile at once. every cell is a 4 bit lane, lane masks have the low bit of each lane set
+#define EXP_LANES_LOW  0x1111111111111111ULL
+#define EXP_BYTES_LOW4 0x0F0F0F0F0F0F0F0FULL
+#define EXP_BYTES_HIGH 0x8080808080808080ULL
+
+// lanes that aren't 0
+static inline uint64_t exp_swar_nonzero(uint64_t x) {
+    return (x | (x >> 1) | (x >> 2) | (x >> 3)) & EXP_LANES_LOW;
+}
+// lanes that are 15
+static inline uint64_t exp_swar_full(uint64_t x) {
+    return x & (x >> 1) & (x >> 2) & (x >> 3) & EXP_LANES_LOW;
+}
+// lanes that equal v
+static inline uint64_t exp_swar_eq(uint64_t x, unsigned int v) {
+    return exp_swar_nonzero(x ^ (v * EXP_LANES_LOW)) ^ EXP_LANES_LOW;
+}
+// every lane minus 1, stopping at 0. no lane borrows from the next since only nonzero ones drop
+static inline uint64_t exp_swar_dec(uint64_t x) {
+    return x - exp_swar_nonzero(x);
+}
+// the given lanes plus 1, stopping at 15
+static inline uint64_t exp_swar_inc(uint64_t x, uint64_t lanes) {
+    return x + (lanes & ~exp_swar_full(x));
+}
+// per byte min of two words with every byte 0-15. the high bit of (a | 0x80) - b is left set where a >= b
+static inline uint64_t exp_swar_min_bytes(uint64_t a, uint64_t b) {
+    const uint64_t pick_b = ((((a | EXP_BYTES_HIGH) - b) & EXP_BYTES_HIGH) >> 7) * 0xFF;
+    return (a & ~pick_b) | (b & pick_b);
+}
+// the lowest lane value in x
+static inline unsigned int exp_swar_min(uint64_t x) {
+    uint64_t m = exp_swar_min_bytes(x & EXP_BYTES_LOW4, (x >> 4) & EXP_BYTES_LOW4);
+    m = exp_swar_min_bytes(m, m >> 32);
+    m = exp_swar_min_bytes(m, m >> 16);
+    m = exp_swar_min_bytes(m, m >> 8);
+    return m & 0xF;
+}
+// index of the lowest set lane in a lane mask, mask can't be 0
+static inline int exp_swar_first_lane(uint64_t lanes) {
+    int i = 0;
+    while (!(lanes & 0xF)) {
+        lanes >>= 4;
+        i++;
+    }
+    return i;
+}
+
+static void exp_level_dec_all(exp_level * l) {
+    int i;
+    for (i = 0; i < l->slots; i++) {
+        if (l->tiles[i].used) l->tiles[i].cells = exp_swar_dec(l->tiles[i].cells);
+    }
+}
+
+// adds 1 to the cell at (sx, sy), if it's already full every cell in the level drops by 1 first
+static void exp_level_visit(exp_level * l, float sx, float sy) {
+    int tx, ty, lx, ly;
+    exp_locate(l, sx, sy, &tx, &ty, &lx, &ly);
+
+    exp_tile * t = exp_tile_get(l, tx, ty);
+
+    const uint64_t lane = ((uint64_t) 1) << (4 * (ly * EXP_TILE_CELLS + lx));
+    if (exp_swar_full(t->cells) & lane) exp_level_dec_all(l);
+    t->cells = exp_swar_inc(t->cells, lane);
+}
+
+// the cell at (sx, sy), -1 if its tile isn't stored
+static int exp_level_val(exp_level * l, float sx, float sy) {
+    int tx, ty, lx, ly;
+    exp_locate(l, sx, sy, &tx, &ty, &lx, &ly);
+
+    const exp_tile * t = exp_tile_find(l, tx, ty);
+    return t ? (int) exp_tile_val_at(t, lx, ly) : -1;
+}
+
+// forget everything
+static void exp_map_clear() {
+    memset(exp_fine_tiles, 0, sizeof(exp_fine_tiles));
+    memset(exp_coarse_tiles, 0, sizeof(exp_coarse_tiles));
+    exp_fine.count = 0;
+    exp_coarse.count = 0;
+}
+
+// finds the least visited fine cell with its center in the box [x0, x1] x [y0, y1] (mm). where there's no fine tile the
+// coarse cell there is used for the whole tile. returns the weight and sets (ox, oy) to the cell center
+static unsigned int exp_map_region_min(float x0, float y0, float x1, float y1, float * ox, float * oy) {
+    const int cx0 = ceilf(x0 / EXP_MAP_SPACING), cx1 = floorf(x1 / EXP_MAP_SPACING);
+    const int cy0 = ceilf(y0 / EXP_MAP_SPACING), cy1 = floorf(y1 / EXP_MAP_SPACING);
+
+    unsigned int best = 16;
+    *ox = (x0 + x1) / 2;
+    *oy = (y0 + y1) / 2;
+    if (cx0 > cx1 || cy0 > cy1) return 0;
+
+    int tx, ty;
+    for (ty = exp_floor_div(cy0); ty <= exp_floor_div(cy1) && best > 0; ty++) {
+        for (tx = exp_floor_div(cx0); tx <= exp_floor_div(cx1) && best > 0; tx++) {
+            // the part of the tile inside the box, in cells
+            const int lx0 = MAX(cx0 - tx * EXP_TILE_CELLS, 0), lx1 = MIN(cx1 - tx * EXP_TILE_CELLS, EXP_TILE_CELLS - 1);
+            const int ly0 = MAX(cy0 - ty * EXP_TILE_CELLS, 0), ly1 = MIN(cy1 - ty * EXP_TILE_CELLS, EXP_TILE_CELLS - 1);
+
+            const exp_tile * t = exp_tile_find(&exp_fine, tx, ty);
+            if (!t) {
+                const float fx = (tx * EXP_TILE_CELLS + lx0) * EXP_MAP_SPACING;
+                const float fy = (ty * EXP_TILE_CELLS + ly0) * EXP_MAP_SPACING;
+                const int coarse = exp_level_val(&exp_coarse, fx, fy);
+                const unsigned int value = coarse != -1 ? coarse : 0;
+                if (value < best) {
+                    best = value;
+                    *ox = fx;
+                    *oy = fy;
+                }
+                continue;
+            }
+
+            // lanes outside the box read as 15 so they never win unless everything is 15
+            uint64_t in_box = 0;
+            int x, y;
+            for (x = lx0; x <= lx1; x++) in_box |= ((uint64_t) 1) << (4 * x);
+            for (y = ly0 + 1; y <= ly1; y++) in_box |= in_box << (4 * EXP_TILE_CELLS);
+            in_box <<= 4 * EXP_TILE_CELLS * ly0;
+
+            const uint64_t cells = t->cells | ~(in_box * 0xF);
+            const unsigned int value = exp_swar_min(cells);
+            if (value < best) {
+                const int lane = exp_swar_first_lane(exp_swar_eq(cells, value) & in_box);
+                best = value;
+                *ox = (tx * EXP_TILE_CELLS + lane % EXP_TILE_CELLS) * EXP_MAP_SPACING;
+                *oy = (ty * EXP_TILE_CELLS + lane / EXP_TILE_CELLS) * EXP_MAP_SPACING;
+            }
+        }
+    }
+
+    return best;
+}
+
+// increase the nearest weight on the map by 1 given the robot's position
+static inline void exp_map_new_searched_point(float sx, float sy) {
+    exp_level_visit(&exp_fine, sx, sy);
+    exp_level_visit(&exp_coarse, sx, sy);
+}
+
+// get a weighted point on the map from a position. fine if there's a fine tile there, otherwise coarse
+// a coarse cell counts every visit in 4 by 4 fine cells so it reads higher, which keeps the picker off places it's been before
+static inline unsigned int exp_map_get_weighted_point(float sx, float sy) {
+    const int fine = exp_level_val(&exp_fine, sx, sy);
+    if (fine != -1) return fine;
+
+    const int coarse = exp_level_val(&exp_coarse, sx, sy);
+    return coarse != -1 ? coarse : 0;
+}
+
+
+
+// ------------------------------ pathfinding helpers ------------------------------
+// the radius of the bot and the space between objects we want to maintain, accounting for error in some cases
+#define BOT_RADIUS 160
+#define CLEARANCE_TOLERANCE 30
+
+// returns if the object at index is brushed up against an object, defined as dist < BOT_RADIUS + CLEARANCE_TOLERANCE
+static inline char is_object_brushing_bot(int index) {
+    const object_positional *o = &object_map[index];
+    const float distance = dist(o->x, o->y, get_pos_x(), get_pos_y());
+    return distance < BOT_RADIUS + CLEARANCE_TOLERANCE;
+}
+
+// extra room around objects we're sure are hazards (holes), driving into one ends the run
+#define HAZARD_MARGIN 60
+
+static inline float object_hazard_margin(const object_positional * o) {
+    return (o->type == 2 && o->class_confidence >= CLASS_SURE) ? HAZARD_MARGIN : 0;
+}
+
+// the inflated radius of object i, we do not consider the tolerance when too nearby an object for the sake of pathfinding
+// the collision checks don't call this per object, they read the planning snapshot below
+static inline float object_inflated_radius_now(int index) {
+    return object_map[index].radius + object_hazard_margin(&object_map[index]) + BOT_RADIUS + (is_object_brushing_bot(index) ? 0 : CLEARANCE_TOLERANCE);
+}
+
+// squared distance from point (px,py) to segment AB
+static inline float point_segment_dist2(float px, float py, float ax, float ay, float bx, float by) {
+    const float dx = bx - ax;
+    const float dy = by - ay;
+    const float len2 = dx * dx + dy * dy;
+
+    float t = len2 > 0 ? ((px - ax) * dx + (py - ay) * dy) / len2 : 0;
+    if (t < 0.0f) t = 0.0f;
+    else if (t > 1.0f) t = 1.0f;
+
+    const float cx = ax + t * dx - px;
+    const float cy = ay + t * dy - py;
+    return cx * cx + cy * cy;
+}
+
+// inflated half width of wall segment at index, the tolerance is dropped when brushing up against it like with objects
+static inline float segment_inflated_radius_now(int index) {
+    const wall_segment *s = &segment_map[index];
+    const float d2 = point_segment_dist2(get_pos_x(), get_pos_y(), s->ax, s->ay, s->bx, s->by);
+    const float brushing = BOT_RADIUS + CLEARANCE_TOLERANCE;
+    return BOT_RADIUS + (d2 < brushing * brushing ? 0 : CLEARANCE_TOLERANCE);
+}
+
+
+
+
+// ------------------------------ planning snapshot ------------------------------
+// the collision checks run down flat arrays of each object's x, y and inflated radius in whole mm, rebuilt only when the
+// map version changes. the radius there is the biggest it can be (with the tolerance, rounded out), so the snapshot can
+// only rule an object out. a hit is checked again exactly against object_map, which is where the tolerance is dropped
+// for an object the bot is brushing (see is_object_brushing_bot), since that depends on where the bot is right now
+// walls work the same way, against the full half width first and the exact one on a hit
+
+static int16_t plan_obj_x[OBJECT_MAP_SIZE];
+static int16_t plan_obj_y[OBJECT_MAP_SIZE];
+static int16_t plan_obj_r[OBJECT_MAP_SIZE];
+
+static unsigned int plan_object_version = 0;
+static char plan_built = 0;
+unsigned int plan_snapshot_builds = 0;
+
+#define PLAN_WALL_R2_MAX ((float) (BOT_RADIUS + CLEARANCE_TOLERANCE) * (BOT_RADIUS + CLEARANCE_TOLERANCE))
+
+static void plan_snapshot_build() {
+    int i;
+    for (i = 0; i < object_map_c; i++) {
+        const object_positional *o = &object_map[i];
+        plan_obj_x[i] = lroundf(o->x);
+        plan_obj_y[i] = lroundf(o->y);
+        plan_obj_r[i] = ceilf(o->radius + object_hazard_margin(o) + BOT_RADIUS + CLEARANCE_TOLERANCE) + 1; // + 1 covers the rounded center
+    }
+
+    plan_object_version = object_map_version;
+    plan_built = 1;
+    plan_snapshot_builds++;
+}
+
+// rebuilds the snapshot if the map changed since
+static inline void plan_snapshot_update() {
+    if (plan_built && plan_object_version == object_map_version) return;
+    plan_snapshot_build();
+}
+
+// squared distance from the segment starting (fx, fy) from a circle center along (dx, dy) to that center
+// inv_len2 is 1 / (dx^2 + dy^2)
+static inline float plan_segment_dist2(float fx, float fy, float dx, float dy, float inv_len2) {
+    // project center onto segment (parameter t in [0,1])
+    float t = -(fx * dx + fy * dy) * inv_len2;
+    t = t < 0.0f ? 0.0f : t;
+    t = t > 1.0f ? 1.0f : t;
+
+    const float cx = fx + t * dx;
+    const float cy = fy + t * dy;
+    return cx * cx + cy * cy;
+}
+
+// returns 1 if point (px,py) is inside or touching the inflated object at index
+static inline char object_blocks_point(int index, float px, float py) {
+    const float dx = px - plan_obj_x[index];
+    const float dy = py - plan_obj_y[index];
+    const float r = plan_obj_r[index];
+    if (dx * dx + dy * dy > r * r) return 0;
+
+    const object_positional *o = &object_map[index];
+    const float ex = px - o->x;
+    const float ey = py - o->y;
+    const float er = object_inflated_radius_now(index);
+    return ex * ex + ey * ey <= er * er;
+}
+
+// returns 1 if the segment from (ax,ay) along (dx,dy) comes within clearance of the inflated object at index
+// inv_len2 is 1 / (dx^2 + dy^2)
+static inline char object_blocks_segment(int index, float ax, float ay, float dx, float dy, float inv_len2) {
+    const float r = plan_obj_r[index];
+    if (plan_segment_dist2(ax - plan_obj_x[index], ay - plan_obj_y[index], dx, dy, inv_len2) > r * r) return 0;
+
+    const object_positional *o = &object_map[index];
+    const float er = object_inflated_radius_now(index);
+    return plan_segment_dist2(ax - o->x, ay - o->y, dx, dy, inv_len2) <= er * er;
+}
+
+// 1 if d2 is within the inflated half width of the wall segment at index
+static inline char wall_within(int index, float d2) {
+    if (d2 > PLAN_WALL_R2_MAX) return 0;
+    const float r = segment_inflated_radius_now(index);
+    return d2 <= r * r;
+}
+
+// returns 1 if point (px,py) is too close to the wall segment at index. for the border, anything past it counts too
+static char wall_blocks_point(int index, float px, float py) {
+    const wall_segment *s = &segment_map[index];
+
+    if (wall_within(index, point_segment_dist2(px, py, s->ax, s->ay, s->bx, s->by))) return 1;
+
+    if (s->type == 3) {
+        // outside is on the right going a to b, only along the stretch of border we know about
+        const float dx = s->bx - s->ax;
+        const float dy = s->by - s->ay;
+        const float t = (px - s->ax) * dx + (py - s->ay) * dy;
+        const float side = (px - s->ax) * dy - (py - s->ay) * dx;
+        if (side > 0 && t >= 0 && t <= dx * dx + dy * dy) return 1;
+    }
+
+    return 0;
+}
+
+// returns 1 if segment AB crosses or comes within clearance of the wall segment at index
+static char wall_blocks_segment(int index, float ax, float ay, float bx, float by) {
+    const wall_segment *s = &segment_map[index];
+
+    if (wall_blocks_point(index, ax, ay) || wall_blocks_point(index, bx, by)) return 1;
+
+    // proper crossing, each segment's ends are on opposite sides of the other
+    const float d1 = (s->bx - s->ax) * (ay - s->ay) - (s->by - s->ay) * (ax - s->ax);
+    const float d2 = (s->bx - s->ax) * (by - s->ay) - (s->by - s->ay) * (bx - s->ax);
+    const float d3 = (bx - ax) * (s->ay - ay) - (by - ay) * (s->ax - ax);
+    const float d4 = (bx - ax) * (s->by - ay) - (by - ay) * (s->bx - ax);
+    if (((d1 > 0) != (d2 > 0)) && ((d3 > 0) != (d4 > 0))) return 1;
+
+    // otherwise the closest approach is at one of the four ends
+    return wall_within(index, MIN(point_segment_dist2(s->ax, s->ay, ax, ay, bx, by), point_segment_dist2(s->bx, s->by, ax, ay, bx, by)));
+}
+
+
+
+// ------------------------------ object spatial index ------------------------------
+// a spatial hash over object_map so collision checks only test the objects near the point or along the segment
+// each object is listed in every cell its inflated bounding box touches. an object whose box spans more than
+// OBJ_INDEX_MAX_SPAN cells a side (a very wide one, or a big hazard margin on a cell edge) or that doesn't fit in the entry
+// pool goes on an oversized list that every query checks. walls and the border are segments and never land here, see
+// main_segments.h. rebuilt when object_map_version changes
+
+#define OBJ_INDEX_CELL 500.0f // mm
+#define OBJ_INDEX_BUCKETS 64 // power of 2
+#define OBJ_INDEX_MAX_SPAN 4 // cells per axis before an object is oversized
+#define OBJ_INDEX_MAX_ENTRIES 384
+#define OBJ_INDEX_NONE (-1)
+
+static int16_t obj_index_head[OBJ_INDEX_BUCKETS];
+static int16_t obj_index_next[OBJ_INDEX_MAX_ENTRIES];
+static uint8_t obj_index_obj[OBJ_INDEX_MAX_ENTRIES];
+
+static uint8_t obj_index_oversized[OBJECT_MAP_SIZE];
+static int obj_index_oversized_c = 0;
+
+static unsigned int obj_index_version = 0;
+static char obj_index_built = 0;
+
+// stamped per query so an object listed in several visited cells is only tested once
+static uint16_t obj_index_stamp[OBJECT_MAP_SIZE];
+static uint16_t obj_index_query = 0;
+
+static inline int obj_index_cell(float v) {
+    return (int) floorf(v / OBJ_INDEX_CELL);
+}
+
+static inline unsigned int obj_index_bucket(int cx, int cy) {
+    return (((unsigned int) cx * 73856093u) ^ ((unsigned int) cy * 19349663u)) & (OBJ_INDEX_BUCKETS - 1);
+}
+
+static void obj_index_rebuild() {
+    int i, cx, cy;
+    for (i = 0; i < OBJ_INDEX_BUCKETS; i++) obj_index_head[i] = OBJ_INDEX_NONE;
+
+    int entries_c = 0;
+    obj_index_oversized_c = 0;
+
+    for (i = 0; i < object_map_c; i++) {
+        const object_positional *o = &object_map[i];
+        const float r = o->radius + object_hazard_margin(o) + BOT_RADIUS + CLEARANCE_TOLERANCE; // the most it can be inflated by
+
+        const int x0 = obj_index_cell(o->x - r);
+        const int x1 = obj_index_cell(o->x + r);
+        const int y0 = obj_index_cell(o->y - r);
+        const int y1 = obj_index_cell(o->y + r);
+
+        const int span_x = x1 - x0 + 1;
+        const int span_y = y1 - y0 + 1;
+        if (span_x > OBJ_INDEX_MAX_SPAN || span_y > OBJ_INDEX_MAX_SPAN || entries_c + span_x * span_y > OBJ_INDEX_MAX_ENTRIES) {
+            obj_index_oversized[obj_index_oversized_c++] = i;
+            continue;
+        }
+
+        for (cx = x0; cx <= x1; cx++) {
+            for (cy = y0; cy <= y1; cy++) {
+                const unsigned int bucket = obj_index_bucket(cx, cy);
+                obj_index_obj[entries_c] = i;
+                obj_index_next[entries_c] = obj_index_head[bucket];
+                obj_index_head[bucket] = entries_c;
+                entries_c++;
+            }
+        }
+    }
+
+    obj_index_version = object_map_version;
+    obj_index_built = 1;
+}
+
+// call at the start of each query. rebuilds if the map changed and starts a new stamp
+static void obj_index_begin_query() {
+    if (!obj_index_built || obj_index_version != object_map_version) obj_index_rebuild();
+
+    if (++obj_index_query == 0) { // wrapped, old stamps could collide
+        int i;
+        for (i = 0; i < OBJECT_MAP_SIZE; i++) obj_index_stamp[i] = 0;
+        obj_index_query = 1;
+    }
+}
+
+// 1 if object index hasn't been tested yet this query, and marks it as tested
+static inline char obj_index_visit(int index) {
+    if (obj_index_stamp[index] == obj_index_query) return 0;
+    obj_index_stamp[index] = obj_index_query;
+    return 1;
+}
+
+
+
+// returns 1 if point (px,py) is in free space (not colliding with any inflated object)
+static char is_point_free(float px, float py) {
+    plan_snapshot_update();
+
+#if OCC_PLANNING
+    if (occ_point_blocked(px, py)) return 0;
+#endif
+
+    int i;
+    for (i = 0; i < segment_map_c; ++i) {
+        if (wall_blocks_point(i, px, py)) return 0;
+    }
+
+    obj_index_begin_query();
+
+    for (i = 0; i < obj_index_oversized_c; ++i) {
+        if (object_blocks_point(obj_index_oversized[i], px, py)) return 0;
+    }
+
+    int16_t e;
+    for (e = obj_index_head[obj_index_bucket(obj_index_cell(px), obj_index_cell(py))]; e != OBJ_INDEX_NONE; e = obj_index_next[e]) {
+        const int index = obj_index_obj[e];
+        if (!obj_index_visit(index)) continue;
+
+        if (object_blocks_point(index, px, py)) {
+            // Inside or touching inflated obstacle
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// returns 1 if segment AB is collision-free against all inflated objects
+// walks the index cells the segment passes through (amanatides and woo)
+static char segment_clear(float ax, float ay, float bx, float by) {
+    int i;
+    float dx = bx - ax;
+    float dy = by - ay;
+    float seg_len2 = dx * dx + dy * dy;
+
+    if (seg_len2 == 0.0f) {
+        // Degenerate segment, just test the point.
+        return is_point_free(ax, ay);
+    }
+    const float inv_len2 = 1.0f / seg_len2;
+
+    plan_snapshot_update();
+
+#if OCC_PLANNING
+    if (occ_segment_blocked(ax, ay, bx, by)) return 0;
+#endif
+
+    for (i = 0; i < segment_map_c; ++i) {
+        if (wall_blocks_segment(i, ax, ay, bx, by)) return 0;
+    }
+
+    obj_index_begin_query();
+
+    for (i = 0; i < obj_index_oversized_c; ++i) {
+        if (object_blocks_segment(obj_index_oversized[i], ax, ay, dx, dy, inv_len2)) return 0;
+    }
+
+    int cx = obj_index_cell(ax);
+    int cy = obj_index_cell(ay);
+    const int ex = obj_index_cell(bx);
+    const int ey = obj_index_cell(by);
+
+    const int step_x = dx > 0 ? 1 : -1;
+    const int step_y = dy > 0 ? 1 : -1;
+
+    // segment parameter (0-1) where the next cell boundary is crossed on each axis, and how far apart boundaries are
+    const float BIG = 1.0e30f;
+    float t_max_x = dx != 0 ? ((cx + (step_x > 0)) * OBJ_INDEX_CELL - ax) / dx : BIG;
+    float t_max_y = dy != 0 ? ((cy + (step_y > 0)) * OBJ_INDEX_CELL - ay) / dy : BIG;
+    const float t_delta_x = dx != 0 ? OBJ_INDEX_CELL / fabsf(dx) : BIG;
+    const float t_delta_y = dy != 0 ? OBJ_INDEX_CELL / fabsf(dy) : BIG;
+
+    // every step moves one cell closer to the end, so this is exactly the cells crossed
+    int steps = abs(ex - cx) + abs(ey - cy);
+    for (;;) {
+        int16_t e;
+        for (e = obj_index_head[obj_index_bucket(cx, cy)]; e != OBJ_INDEX_NONE; e = obj_index_next[e]) {
+            const int index = obj_index_obj[e];
+            if (!obj_index_visit(index)) continue;
+
+            if (object_blocks_segment(index, ax, ay, dx, dy, inv_len2)) {
+                // The path comes within clearance of this obstacle
+                return 0;
+            }
+        }
+
+        if (steps-- <= 0) break;
+
+        if (cx != ex && (cy == ey || t_max_x < t_max_y)) {
+            cx += step_x;
+            t_max_x += t_delta_x;
+        } else {
+            cy += step_y;
+            t_max_y += t_delta_y;
+        }
+    }
+
+    return 1;
+}
+
+
+// ------------------------------ random point selection ------------------------------
+#define GLOBAL_HALF_SIZE_MM 5000.0f
+#define GLOBAL_MIN_MM (-GLOBAL_HALF_SIZE_MM)
+#define GLOBAL_MAX_MM ( GLOBAL_HALF_SIZE_MM)
+
+typedef struct SamplePoint {
+    int16_t x, y;
+} SamplePoint;
+
+#define SAMPLE_POINT_CNT 64
+#define SAMPLE_REFINE_HALF_MM (EXP_COARSE_SPACING / 2) // the best sample moves to the least visited free cell this close to it
+
+// selects a random valid xy point within 5000 of the bot, prioritizes low values in the exp_map (ie, lesser explored points)
+static void exp_map_pick_random_point(float * ox, float * oy) {
+    // generate a set of random points to try, should all be not inside of obstacle
+    SamplePoint sample_points[SAMPLE_POINT_CNT];
+    int i;
+    for (i = 0; i < SAMPLE_POINT_CNT; i++) {
+        do {
+            sample_points[i].x = roundf(get_pos_x() + exp_rand_range(GLOBAL_MIN_MM, GLOBAL_MAX_MM));
+            sample_points[i].y = roundf(get_pos_y() + exp_rand_range(GLOBAL_MIN_MM, GLOBAL_MAX_MM));
+        } while (!is_point_free(sample_points[i].x, sample_points[i].y));
+    }
+
+
+    // find the lowest sample point
+    unsigned int lowest_index = 0;
+    unsigned int lowest_value = exp_map_get_weighted_point(sample_points[0].x, sample_points[0].y);
+
+    for (i = 1; i < SAMPLE_POINT_CNT; i++) {
+        unsigned int value = exp_map_get_weighted_point(sample_points[i].x, sample_points[i].y);
+
+        if (value < lowest_value) {
+            lowest_index = i;
+            lowest_value = value;
+        }
+    }
+
+    *ox = sample_points[lowest_index].x;
+    *oy = sample_points[lowest_index].y;
+
+    // the samples are sparse, so there's often a less visited cell right next to the winner
+    if (lowest_value == 0) return;
+
+    float rx, ry;
+    const unsigned int region_value = exp_map_region_min(*ox - SAMPLE_REFINE_HALF_MM, *oy - SAMPLE_REFINE_HALF_MM,
+                                                         *ox + SAMPLE_REFINE_HALF_MM, *oy + SAMPLE_REFINE_HALF_MM, &rx, &ry);
+    if (region_value < lowest_value && is_point_free(rx, ry)) {
+        *ox = rx;
+        *oy = ry;
+    }
+}
+
+
+
+
+
+// ------------------------------ main pathfinding algorithm ------------------------------
+// a visibility graph: a ring of waypoints just outside every inflated object and past the ends of every wall, joined
+// wherever the straight line between two of them is clear, searched with A* from the start to the target
+// only the objects and walls most in the way (smallest detour through them) get waypoints when there are too many for
+// MAX_CANDIDATES, and edges are only checked when A* gets to them, so most plans never test most of the graph
+
+#define MAX_CANDIDATES 64
+#define DUPLICATE_EPS2 (25.0f)   // 5 mm squared
+
+#define PATH_RING_POINTS 6 // waypoints around each object
+#define PATH_RING_SCALE 1.16f // just over 1 / cos(180 / PATH_RING_POINTS), so the line between two neighbors clears the object
+#define PATH_MAX_EDGE_CHECKS 1024 // segment_clear calls a plan may make before it gives up, keeps the worst case bounded
+
+// Add a candidate waypoint if it's free and not (almost) duplicate.
+static void add_candidate(float x, float y, float *cand_x, float *cand_y, int *cand_count) {
+    int i;
+
+    if (*cand_count >= MAX_CANDIDATES) {
+        return;
+    }
+
+    if (!is_point_free(x, y)) {
+        return;
+    }
+
+    for (i = 0; i < *cand_count; ++i) {
+        float dx = x - cand_x[i];
+        float dy = y - cand_y[i];
+        if (dx * dx + dy * dy < DUPLICATE_EPS2) {
+            return;
+        }
+    }
+
+    cand_x[*cand_count] = x;
+    cand_y[*cand_count] = y;
+    (*cand_count)++;
+}
+
+// graph nodes, 0 is the start, 1 to cand_count are the candidates, the last is the target
+#define PATH_NODES (MAX_CANDIDATES + 2)
+
+static float path_node_x[PATH_NODES];
+static float path_node_y[PATH_NODES];
+static float path_g[PATH_NODES]; // best known distance from the start
+static int8_t path_parent[PATH_NODES];
+static char path_closed[PATH_NODES];
+static char path_tried[PATH_NODES];
+
+// objects and walls by how much of a detour going past them is, smallest first
+typedef struct path_obstacle {
+    float detour;
+    int16_t index; // object index, or -1 - segment index for a wall
+} path_obstacle;
+
+static path_obstacle path_obstacles[OBJECT_MAP_SIZE + SEGMENT_MAP_SIZE];
+
+unsigned int path_edge_checks = 0; // segment_clear calls in the last plan
+
+// lines already found blocked this plan, a bit per node pair, so the lazy search never checks one twice
+static uint8_t path_edge_blocked[PATH_NODES][(PATH_NODES + 7) / 8];
+
+// 1 if the line between nodes a and b is clear, counting the check
+static char path_edge_ok(int a, int b) {
+    if ((path_edge_blocked[a][b / 8] >> (b % 8)) & 1) return 0;
+
+    path_edge_checks++;
+    if (segment_clear(path_node_x[a], path_node_y[a], path_node_x[b], path_node_y[b])) return 1;
+
+    path_edge_blocked[a][b / 8] |= 1 << (b % 8);
+    path_edge_blocked[b][a / 8] |= 1 << (a % 8);
+    return 0;
+}
+
+static void path_sort_obstacles(float sx, float sy, float tx, float ty, int * count) {
+    int n = 0;
+    int i, j;
+
+    for (i = 0; i < object_map_c; i++) {
+        path_obstacles[n].detour = dist(sx, sy, object_map[i].x, object_map[i].y) + dist(object_map[i].x, object_map[i].y, tx, ty);
+        path_obstacles[n++].index = i;
+    }
+    for (i = 0; i < segment_map_c; i++) {
+        const wall_segment *w = &segment_map[i];
+        const float da = dist(sx, sy, w->ax, w->ay) + dist(w->ax, w->ay, tx, ty);
+        const float db = dist(sx, sy, w->bx, w->by) + dist(w->bx, w->by, tx, ty);
+        path_obstacles[n].detour = MIN(da, db);
+        path_obstacles[n++].index = -1 - i;
+    }
+
+    // insertion sort, it's at most 80
+    for (i = 1; i < n; i++) {
+        const path_obstacle p = path_obstacles[i];
+        for (j = i - 1; j >= 0 && path_obstacles[j].detour > p.detour; j--) path_obstacles[j + 1] = path_obstacles[j];
+        path_obstacles[j + 1] = p;
+    }
+
+    *count = n;
+}
+
+// adds the waypoint candidates around the i-th obstacle of path_sort_obstacles, the search goes down the list one per step
+// so the ones around what's most in the way come first
+static void path_add_obstacle_candidates(int i, float sx, float sy, float *cand_x, float *cand_y, int *cand_count) {
+    int k;
+    if (path_obstacles[i].index >= 0) {
+        // a ring around the object, the first point faces the start
+        const object_positional *o = &object_map[path_obstacles[i].index];
+        const float ring = (o->radius + object_hazard_margin(o) + BOT_RADIUS + CLEARANCE_TOLERANCE) * PATH_RING_SCALE + 2.0f;
+        const float a0 = atan2f(sy - o->y, sx - o->x);
+
+        for (k = 0; k < PATH_RING_POINTS; k++) {
+            const float a = a0 + k * (2 * M_PI / PATH_RING_POINTS);
+            add_candidate(o->x + ring * cosf(a), o->y + ring * sinf(a), cand_x, cand_y, cand_count);
+        }
+    }
+    else {
+        // past each end of the wall, on the side we're on for the border
+        const wall_segment *w = &segment_map[-1 - path_obstacles[i].index];
+
+        float wux, wuy, wlen;
+        segment_dir(w, &wux, &wuy, &wlen);
+
+        const float offset = (BOT_RADIUS + CLEARANCE_TOLERANCE) * 1.3f;
+
+        int end;
+        for (end = -1; end <= 1; end += 2) {
+            const float ex = (end < 0 ? w->ax : w->bx) + end * wux * offset;
+            const float ey = (end < 0 ? w->ay : w->by) + end * wuy * offset;
+
+            // left of a to b is inside for the border
+            add_candidate(ex - wuy * offset, ey + wux * offset, cand_x, cand_y, cand_count);
+            if (w->type != 3) {
+                add_candidate(ex + wuy * offset, ey - wux * offset, cand_x, cand_y, cand_count);
+                add_candidate(ex, ey, cand_x, cand_y, cand_count);
+            }
+        }
+    }
+}
+
+// the search runs in steps so it can be paused (see the anytime planner further down), all of its state is above. the
+// setup is steps too: the end points and the straight line first, then sorting the obstacles, then the candidates around
+// one obstacle per step, and only then the graph search
+#define PATH_SEARCH_RUNNING (-1)
+
+#define PATH_PHASE_ENDS 0
+#define PATH_PHASE_SORT 1
+#define PATH_PHASE_CANDIDATES 2
+#define PATH_PHASE_SEARCH 3
+
+static int path_node_c = 0; // nodes in the search, the start is 0 and the target is the last one. 0 until the graph search
+static char path_anytime_active = 0; // 1 while an anytime plan owns the search state
+
+static char path_phase = PATH_PHASE_ENDS;
+static float path_search_tx = 0, path_search_ty = 0; // the target, it only gets a node once the candidates are in
+static int path_obstacle_c = 0;
+static int path_obstacle_next = 0; // the next obstacle to put candidates around
+static int path_cand_c = 0;
+
+// sets up a search from (sx, sy) to (tx, ty), visibility_step does the rest
+static void visibility_begin(float sx, float sy, float tx, float ty) {
+    path_edge_checks = 0;
+    path_node_c = 0;
+    path_node_x[0] = sx;
+    path_node_y[0] = sy;
+    path_search_tx = tx;
+    path_search_ty = ty;
+    path_phase = PATH_PHASE_ENDS;
+}
+
+// the candidates are in, lay out the graph
+static void visibility_start_search() {
+    path_node_c = path_cand_c + 2;
+    const int target = path_node_c - 1;
+    path_node_x[target] = path_search_tx;
+    path_node_y[target] = path_search_ty;
+
+    int i;
+    for (i = 0; i < path_node_c; i++) {
+        path_g[i] = 1.0e30f;
+        path_parent[i] = -1;
+        path_closed[i] = 0;
+    }
+    path_g[0] = 0;
+    memset(path_edge_blocked, 0, sizeof(path_edge_blocked));
+
+    path_phase = PATH_PHASE_SEARCH;
+}
+
+// one step of lazy A*, the open set is every unclosed node with a finite g. it's small enough to just scan
+// nodes are relaxed without checking the line to them, that's only done once a node is picked to be closed. if its line
+// turns out blocked it takes the best closed parent it can actually see instead, or drops out until something else reaches it
+static int visibility_search_step() {
+    const int node_c = path_node_c;
+    const int target = node_c - 1;
+    const float tx = path_node_x[target];
+    const float ty = path_node_y[target];
+
+    int i;
+    int u = -1;
+    float best_f = 1.0e30f;
+    for (i = 0; i < node_c; i++) {
+        if (path_closed[i] || path_g[i] >= 1.0e30f) continue;
+
+        const float f = path_g[i] + dist(path_node_x[i], path_node_y[i], tx, ty);
+        if (f < best_f) {
+            u = i;
+            best_f = f;
+        }
+    }
+
+    if (u == -1) return 0; // nothing left, no path
+
+    if (path_edge_checks > PATH_MAX_EDGE_CHECKS) {
+        ur_send_line("Warning: visibility planner ran out of edge checks");
+        return 0;
+    }
+
+    if (u != 0 && !path_edge_ok(path_parent[u], u)) {
+        // closed parents by cost, until one can see u
+        path_g[u] = 1.0e30f;
+        memset(path_tried, 0, node_c);
+        path_tried[path_parent[u]] = 1;
+        path_parent[u] = -1;
+
+        while (1) {
+            int p = -1;
+            float best_g = 1.0e30f;
+            for (i = 0; i < node_c; i++) {
+                if (!path_closed[i] || path_tried[i]) continue;
+
+                const float g = path_g[i] + dist(path_node_x[i], path_node_y[i], path_node_x[u], path_node_y[u]);
+                if (g < best_g) {
+                    p = i;
+                    best_g = g;
+                }
+            }
+
+            if (p == -1) break;
+            path_tried[p] = 1;
+
+            if (path_edge_ok(p, u)) {
+                path_g[u] = best_g;
+                path_parent[u] = p;
+                break;
+            }
+        }
+        return PATH_SEARCH_RUNNING;
+    }
+
+    if (u == target) return 1;
+    path_closed[u] = 1;
+
+    for (i = 0; i < node_c; i++) {
+        if (path_closed[i]) continue;
+
+        const float g = path_g[u] + dist(path_node_x[u], path_node_y[u], path_node_x[i], path_node_y[i]);
+        if (g < path_g[i]) {
+            path_g[i] = g;
+            path_parent[i] = u;
+        }
+    }
+    return PATH_SEARCH_RUNNING;
+}
+
+// one step of the setup or the search. returns PATH_SEARCH_RUNNING, 0 if there's no path, or 1 once the target is reached
+static int visibility_step() {
+    const float sx = path_node_x[0];
+    const float sy = path_node_y[0];
+    const float tx = path_search_tx;
+    const float ty = path_search_ty;
+
+    if (path_phase == PATH_PHASE_ENDS) {
+        // start and target must be in free space
+        if (!is_point_free(sx, sy) || !is_point_free(tx, ty)) return 0;
+
+        // straight there, a graph of just the two ends
+        path_edge_checks++;
+        if (segment_clear(sx, sy, tx, ty)) {
+            path_node_c = 2;
+            path_node_x[1] = tx;
+            path_node_y[1] = ty;
+            path_parent[1] = 0;
+            return 1;
+        }
+
+        path_phase = PATH_PHASE_SORT;
+        return PATH_SEARCH_RUNNING;
+    }
+
+    if (path_phase == PATH_PHASE_SORT) {
+        path_sort_obstacles(sx, sy, tx, ty, &path_obstacle_c);
+        path_obstacle_next = 0;
+        path_cand_c = 0;
+        path_phase = PATH_PHASE_CANDIDATES;
+        return PATH_SEARCH_RUNNING;
+    }
+
+    if (path_phase == PATH_PHASE_CANDIDATES) {
+        if (path_obstacle_next < path_obstacle_c && path_cand_c < MAX_CANDIDATES) {
+            path_add_obstacle_candidates(path_obstacle_next++, sx, sy, &path_node_x[1], &path_node_y[1], &path_cand_c);
+        }
+        else visibility_start_search();
+        return PATH_SEARCH_RUNNING;
+    }
+
+    return visibility_search_step();
+}
+
+// writes the waypoints from the start to node (not including the start) into wx, wy. returns how many there are
+static int visibility_extract(int node, float *wx, float *wy, int max_waypoints) {
+    // walk back to count the hops, then write them out front to back
+    int n = 0;
+    int i;
+    for (i = node; i != 0; i = path_parent[i]) n++;
+
+    int k = n;
+    for (i = node; i != 0; i = path_parent[i]) {
+        k--;
+        if (k < max_waypoints) {
+            wx[k] = path_node_x[i];
+            wy[k] = path_node_y[i];
+        }
+    }
+
+    return n;
+}
+
+// the visibility graph backend of path_to_full
+int visibility_path_full(float sx, float sy, float tx, float ty, float *wx, float *wy, int max_waypoints) {
+    path_anytime_active = 0; // the search state is about to be reused
+    visibility_begin(sx, sy, tx, ty);
+
+    int r;
+    do {
+        r = visibility_step();
+    } while (r == PATH_SEARCH_RUNNING);
+
+    return r ? visibility_extract(path_node_c - 1, wx, wy, max_waypoints) : 0;
+}
+
+// ------------------------------ planner backends ------------------------------
+// path_to_full runs whichever backend path_backend picks, and keeps success and timing stats for each so they can be
+// compared. with path_compare set every backend plans every query (only the picked one's path is used), so the stats
+// are all from the same maps. the grid searches share one arena, so comparing also makes d* lite start over every plan
+// a grid backend that finds nothing falls back to the visibility graph, the raster can close gaps the bot fits through
+// the visibility graph is the default. it plans on the real shapes with no grid edge to stop at, and it's the one the
+// anytime planner runs in slices. d* lite (b3) is kept for maps that keep changing on the way to one target: a plan only
+// repairs the cells that flipped, about half the cells a fresh grid a* closes, and it gets stuck less when objects keep
+// turning up in front of the bot. the cost is the 3.6m grid, so a far target is reached in stretches
+
+#define PATH_BACKEND_VISIBILITY 0
+#define PATH_BACKEND_GRID_ASTAR 1
+#define PATH_BACKEND_GRID_THETA 2
+#define PATH_BACKEND_GRID_DSTAR 3
+#define PATH_BACKEND_COUNT 4
+
+char path_backend = PATH_BACKEND_VISIBILITY;
+char path_compare = 0;
+
+typedef struct path_backend_stats {
+    unsigned int plans;
+    unsigned int found;
+    unsigned int total_us;
+    unsigned int max_us;
+} path_backend_stats;
+
+path_backend_stats path_stats[PATH_BACKEND_COUNT];
+
+// in main_grid_planner.h
+int grid_path_full(float sx, float sy, float tx, float ty, float *wx, float *wy, int max_waypoints, char mode);
+int grid_dstar_path_full(float sx, float sy, float tx, float ty, float *wx, float *wy, int max_waypoints);
+
+static int path_run_backend(char backend, float sx, float sy, float tx, float ty, float *wx, float *wy, int max_waypoints) {
+    const unsigned int start = timer_getMicros();
+
+    int n;
+    if (backend == PATH_BACKEND_GRID_ASTAR)      n = grid_path_full(sx, sy, tx, ty, wx, wy, max_waypoints, 0);
+    else if (backend == PATH_BACKEND_GRID_THETA) n = grid_path_full(sx, sy, tx, ty, wx, wy, max_waypoints, 1);
+    else if (backend == PATH_BACKEND_GRID_DSTAR) n = grid_dstar_path_full(sx, sy, tx, ty, wx, wy, max_waypoints);
+    else                                         n = visibility_path_full(sx, sy, tx, ty, wx, wy, max_waypoints);
+
+    const unsigned int elapsed = timer_getMicros() - start;
+
+    path_backend_stats *st = &path_stats[(int) backend];
+    st->plans++;
+    if (n > 0) st->found++;
+    st->total_us += elapsed;
+    if (elapsed > st->max_us) st->max_us = elapsed;
+
+    return n;
+}
+
+// runs the picked backend (and the rest when comparing), falling back to the visibility graph if a grid backend finds nothing
+static int path_plan(float sx, float sy, float tx, float ty, float *wx, float *wy, int max_waypoints) {
+    if (path_compare) {
+        float cx, cy;
+        char b;
+        for (b = 0; b < PATH_BACKEND_COUNT; b++) {
+            if (b != path_backend) path_run_backend(b, sx, sy, tx, ty, &cx, &cy, 1);
+        }
+    }
+
+    const int n = path_run_backend(path_backend, sx, sy, tx, ty, wx, wy, max_waypoints);
+    if (n > 0 || path_backend == PATH_BACKEND_VISIBILITY) return n;
+
+    return path_run_backend(PATH_BACKEND_VISIBILITY, sx, sy, tx, ty, wx, wy, max_waypoints);
+}
+
+
+
+
+// ------------------------------ path cache ------------------------------
+// explore_loop_path only drives the first 300mm of a path before it plans again, to the same target most of the time. the
+// whole path is kept here with the map versions it was checked against, and the next plan to that target just drops the
+// waypoints the bot got to and re-checks what's left (only the leg from the bot if nothing changed). it's planned again
+// only when one of those legs is blocked or the bot ended up off the leg it was driving
+
+#define PATH_CACHE_SIZE 16 // waypoints kept, a longer path is still used but not cached
+#define PATH_CACHE_MAX_OFF 100.0f // mm the bot can be off the leg it was driving
+#define PATH_CACHE_REACHED 50.0f // mm from a waypoint that counts as there, explore_loop_path won't drive less than this
+
+static float path_cache_x[PATH_CACHE_SIZE];
+static float path_cache_y[PATH_CACHE_SIZE];
+static int path_cache_c = 0; // 0 when nothing is cached
+static int path_cache_next = 0; // the first waypoint not reached yet
+static float path_cache_from_x = 0, path_cache_from_y = 0; // start of the leg to the next waypoint
+static float path_cache_tx = 0, path_cache_ty = 0;
+static unsigned int path_cache_object_version = 0;
+static unsigned int path_cache_segment_version = 0;
+static unsigned int path_cache_occ_version = 0;
+
+unsigned int path_cache_hits = 0;
+unsigned int path_cache_rechecks = 0; // hits where the map had changed and the rest of the path was checked again
+unsigned int path_cache_misses = 0;
+
+// forget the cached path
+void path_cache_clear() {
+    path_cache_c = 0;
+    path_anytime_active = 0;
+}
+
+static void path_cache_stamp() {
+    path_cache_object_version = object_map_version;
+    path_cache_segment_version = segment_map_version;
+    path_cache_occ_version = occ_version;
+}
+
+// the cached path to (tx, ty) if it's still good from (sx, sy). returns how many waypoints are left, 0 if it has to be planned
+static int path_cache_lookup(float sx, float sy, float tx, float ty) {
+    if (path_cache_c == 0 || tx != path_cache_tx || ty != path_cache_ty) return 0;
+
+    // drop the waypoints the bot got to
+    while (path_cache_next < path_cache_c - 1 && dist(sx, sy, path_cache_x[path_cache_next], path_cache_y[path_cache_next]) < PATH_CACHE_REACHED) {
+        path_cache_from_x = path_cache_x[path_cache_next];
+        path_cache_from_y = path_cache_y[path_cache_next];
+        path_cache_next++;
+    }
+
+    const float next_x = path_cache_x[path_cache_next];
+    const float next_y = path_cache_y[path_cache_next];
+
+    // a grid plan to a far target is cut short and ends before it. once the bot is at that end, plan the next stretch
+    const char at_end = path_cache_next == path_cache_c - 1 && dist(sx, sy, next_x, next_y) < PATH_CACHE_REACHED;
+    if (at_end && (next_x != tx || next_y != ty)) return 0;
+
+    if (point_segment_dist2(sx, sy, path_cache_from_x, path_cache_from_y, next_x, next_y) > PATH_CACHE_MAX_OFF * PATH_CACHE_MAX_OFF) return 0;
+
+    // the bot is never quite on the old leg, so the leg from where it is always gets checked
+    if (!segment_clear(sx, sy, next_x, next_y)) return 0;
+
+    // the rest only if the map changed since they were
+    if (path_cache_object_version != object_map_version || path_cache_segment_version != segment_map_version || path_cache_occ_version != occ_version) {
+        path_cache_rechecks++;
+
+        int i;
+        for (i = path_cache_next; i < path_cache_c - 1; i++) {
+            if (!segment_clear(path_cache_x[i], path_cache_y[i], path_cache_x[i + 1], path_cache_y[i + 1])) return 0;
+        }
+        path_cache_stamp();
+    }
+
+    return path_cache_c - path_cache_next;
+}
+
+// caches the n waypoints already in path_cache_x, y as the path from (sx, sy) to (tx, ty)
+static void path_cache_store(float sx, float sy, float tx, float ty, int n) {
+    path_cache_c = n;
+    path_cache_next = 0;
+    path_cache_from_x = sx;
+    path_cache_from_y = sy;
+    path_cache_tx = tx;
+    path_cache_ty = ty;
+    path_cache_stamp();
+}
+
+// copies the n waypoints left on the cached path (or all of a path too long to cache) out to wx, wy
+static int path_cache_copy(int n, float *wx, float *wy, int max_waypoints) {
+    const int first = (path_cache_c > 0) ? path_cache_next : 0;
+    int i;
+    for (i = 0; i < n && i < max_waypoints && first + i < PATH_CACHE_SIZE; i++) {
+        wx[i] = path_cache_x[first + i];
+        wy[i] = path_cache_y[first + i];
+    }
+    return n;
+}
+
+
+
+// ------------------------------ anytime planning ------------------------------
+// a visibility plan on a busy map can take a long time on the 16MHz cpu, with the bot sitting still. with PATH_ANYTIME on,
+// a plan that isn't done after PATH_ANYTIME_FIRST_US hands back the part of a path it's sure of so far (verified legs to the
+// searched node nearest the target) and the search carries on PATH_ANYTIME_TICK_US at a time from the main loop
+// (path_anytime_tick) while the bot drives that part. the finished path goes into the path cache for the next plan
+// if there's no such part yet, the plan returns no path with path_plan_pending set and the search still going, and the
+// caller asks again for the same target a few main loop passes later
+
+#define PATH_ANYTIME 1
+#define PATH_ANYTIME_FIRST_US 5000 // spent in the plan itself before a partial path is handed back
+#define PATH_ANYTIME_TICK_US 1000 // spent per main loop pass after that
+
+static float path_anytime_sx = 0, path_anytime_sy = 0; // where the running search started from
+static float path_anytime_tx = 0, path_anytime_ty = 0;
+static unsigned int path_anytime_object_version = 0; // the map when it started
+static unsigned int path_anytime_segment_version = 0;
+static unsigned int path_anytime_occ_version = 0;
+static int path_anytime_result = PATH_SEARCH_RUNNING; // how it ended once path_anytime_tick finished it, held for the next plan
+
+// the last target the search gave up on, it isn't tried again until the map changes
+static char path_anytime_failed = 0;
+static float path_anytime_failed_tx = 0, path_anytime_failed_ty = 0;
+static unsigned int path_anytime_failed_object_version = 0;
+static unsigned int path_anytime_failed_segment_version = 0;
+
+unsigned int path_anytime_partials = 0; // plans answered with a partial path
+unsigned int path_anytime_ticks = 0; // main loop passes spent searching
+unsigned int path_anytime_finished = 0; // searches finished from the main loop
+unsigned int path_anytime_pending = 0; // plans answered with nothing yet
+
+// 1 when the last path_to_full found nothing only because the search isn't done, see above
+char path_plan_pending = 0;
+
+// runs the search for up to budget_us. returns PATH_SEARCH_RUNNING if it isn't done
+static int path_anytime_run(unsigned int budget_us) {
+    const unsigned int start = timer_getMicros();
+    int r;
+    do {
+        r = visibility_step();
+    } while (r == PATH_SEARCH_RUNNING && timer_getMicros() - start < budget_us);
+    return r;
+}
+
+// wraps up a search that ended with r. a path goes into the cache stamped with the map the search started on, so if a scan
+// came in while it ran the cache re-checks it before it's used
+static void path_anytime_finish(int r) {
+    if (r == 1) {
+        const int n = visibility_extract(path_node_c - 1, path_cache_x, path_cache_y, PATH_CACHE_SIZE);
+        if (n <= PATH_CACHE_SIZE) {
+            path_cache_store(path_anytime_sx, path_anytime_sy, path_anytime_tx, path_anytime_ty, n);
+            path_cache_object_version = path_anytime_object_version;
+            path_cache_segment_version = path_anytime_segment_version;
+            path_cache_occ_version = path_anytime_occ_version;
+        }
+        path_anytime_failed = 0;
+    }
+    else if (dist(path_anytime_sx, path_anytime_sy, get_pos_x(), get_pos_y()) < PATH_CACHE_REACHED) {
+        // only remembered if it was searched from where the bot is, from anywhere else the answer can be different
+        path_anytime_failed = 1;
+        path_anytime_failed_tx = path_anytime_tx;
+        path_anytime_failed_ty = path_anytime_ty;
+        path_anytime_failed_object_version = object_map_version;
+        path_anytime_failed_segment_version = segment_map_version;
+    }
+}
+
+// the part of a path the running search is sure of: the legs to the searched node nearest the target (it has to be nearer
+// than the start was), less the waypoints the bot already got to from (sx, sy). returns how many, 0 if there isn't one yet
+static int path_anytime_partial(float sx, float sy, float *wx, float *wy, int max_waypoints) {
+    if (path_phase != PATH_PHASE_SEARCH) return 0; // still setting up, nothing is searched yet
+
+    const int target = path_node_c - 1;
+    const float tx = path_node_x[target];
+    const float ty = path_node_y[target];
+
+    int best = -1;
+    float best_d2 = dist2(path_node_x[0], path_node_y[0], tx, ty);
+    int i;
+    for (i = 1; i < target; i++) {
+        if (!path_closed[i]) continue; // closed nodes are the ones whose legs have been checked
+
+        const float d2 = dist2(path_node_x[i], path_node_y[i], tx, ty);
+        if (d2 < best_d2) {
+            best = i;
+            best_d2 = d2;
+        }
+    }
+    if (best == -1) return 0;
+
+    float px[PATH_CACHE_SIZE], py[PATH_CACHE_SIZE];
+    const int n = MIN(PATH_CACHE_SIZE, visibility_extract(best, px, py, PATH_CACHE_SIZE));
+
+    int k = 0;
+    while (k < n - 1 && dist(sx, sy, px[k], py[k]) < PATH_CACHE_REACHED) k++;
+    if (dist(sx, sy, px[k], py[k]) < PATH_CACHE_REACHED || !segment_clear(sx, sy, px[k], py[k])) return 0;
+
+    for (i = k; i < n && i - k < max_waypoints; i++) {
+        wx[i - k] = px[i];
+        wy[i - k] = py[i];
+    }
+    return n - k;
+}
+
+// path_to_full's visibility plan. carries on with the running search when it's for the same target
+static int path_anytime_plan(float sx, float sy, float tx, float ty, float *wx, float *wy, int max_waypoints) {
+    // it already gave up on this target and nothing changed since
+    if (path_anytime_failed && tx == path_anytime_failed_tx && ty == path_anytime_failed_ty &&
+        path_anytime_failed_object_version == object_map_version && path_anytime_failed_segment_version == segment_map_version) return 0;
+
+    // a search finished in the main loop is only good for the map it was done on
+    const char stale = path_anytime_result != PATH_SEARCH_RUNNING && (path_anytime_object_version != object_map_version ||
+        path_anytime_segment_version != segment_map_version || path_anytime_occ_version != occ_version);
+
+    if (!path_anytime_active || tx != path_anytime_tx || ty != path_anytime_ty || stale) {
+        visibility_begin(sx, sy, tx, ty);
+
+        path_anytime_active = 1;
+        path_anytime_result = PATH_SEARCH_RUNNING;
+        path_anytime_sx = sx;
+        path_anytime_sy = sy;
+        path_anytime_tx = tx;
+        path_anytime_ty = ty;
+        path_anytime_object_version = object_map_version;
+        path_anytime_segment_version = segment_map_version;
+        path_anytime_occ_version = occ_version;
+    }
+
+    const int r = path_anytime_result != PATH_SEARCH_RUNNING ? path_anytime_result : path_anytime_run(PATH_ANYTIME_FIRST_US);
+    if (r == PATH_SEARCH_RUNNING) {
+        const int n = path_anytime_partial(sx, sy, wx, wy, max_waypoints);
+        if (n > 0) {
+            path_anytime_partials++;
+            return n;
+        }
+
+        // nowhere worth going yet, path_anytime_tick keeps at it
+        path_anytime_pending++;
+        path_plan_pending = 1;
+        return 0;
+    }
+
+    // used up here, the search state stays as it is until the next search
+    path_anytime_active = 0;
+
+    const char from_here = path_anytime_sx == sx && path_anytime_sy == sy;
+    path_anytime_finish(r);
+    if (r != 1) return 0;
+
+    if (path_cache_c == 0) return visibility_extract(path_node_c - 1, wx, wy, max_waypoints); // too long to cache
+    if (from_here) return path_cache_copy(path_cache_c, wx, wy, max_waypoints);
+
+    // the search started back where the bot was, the cache drops what's behind it and checks the leg from here
+    const int n = path_cache_lookup(sx, sy, tx, ty);
+    if (n > 0) return path_cache_copy(n, wx, wy, max_waypoints);
+
+    // it doesn't hold from here, start over from here
+    path_cache_clear();
+    return path_anytime_plan(sx, sy, tx, ty, wx, wy, max_waypoints);
+}
+
+// keeps a running search going, call it every main loop pass
+void path_anytime_tick() {
+    if (!path_anytime_active || path_anytime_result != PATH_SEARCH_RUNNING) return;
+
+    path_anytime_ticks++;
+    const int r = path_anytime_run(PATH_ANYTIME_TICK_US);
+    if (r != PATH_SEARCH_RUNNING) {
+        path_anytime_finished++;
+        path_anytime_result = r; // the next plan for this target takes it from here
+        path_anytime_finish(r);
+    }
+}
+
+
+
+// plans from (sx, sy) to (tx, ty) and writes the waypoints after the start, ending with the target, into wx, wy
+// returns how many there are (only the first max_waypoints are written), 0 if there is no path
+// with PATH_ANYTIME the visibility backend may return only the start of a path, or 0 with path_plan_pending set, see above
+int path_to_full(float sx, float sy, float tx, float ty, float *wx, float *wy, int max_waypoints) {
+    path_plan_pending = 0;
+
+    int n = path_cache_lookup(sx, sy, tx, ty);
+    if (n > 0) {
+        path_cache_hits++;
+        return path_cache_copy(n, wx, wy, max_waypoints);
+    }
+
+    path_cache_misses++;
+    path_cache_c = 0;
+
+#if PATH_ANYTIME
+    if (path_backend == PATH_BACKEND_VISIBILITY && !path_compare) return path_anytime_plan(sx, sy, tx, ty, wx, wy, max_waypoints);
+#endif
+
+    n = path_plan(sx, sy, tx, ty, path_cache_x, path_cache_y, PATH_CACHE_SIZE);
+    if (n == 0) return 0;
+
+    if (n <= PATH_CACHE_SIZE) path_cache_store(sx, sy, tx, ty, n);
+    return path_cache_copy(n, wx, wy, max_waypoints);
+}
+
+// prints the stats of every backend
+void path_print_stats() {
+    static const char * names[PATH_BACKEND_COUNT] = { "visibility", "grid a*", "grid theta*", "grid d* lite" };
+
+    char buff[112];
+    int b;
+    for (b = 0; b < PATH_BACKEND_COUNT; b++) {
+        const path_backend_stats *st = &path_stats[b];
+        sprintf(buff, "%c%d %-12s - found: %u/%u, avg: %uus, max: %uus", b == path_backend ? '*' : ' ', b, names[b],
+                st->found, st->plans, st->plans ? st->total_us / st->plans : 0, st->max_us);
+        ur_send_line(buff);
+    }
+
+    sprintf(buff, "path cache - hits: %u (%u re-checked), misses: %u", path_cache_hits, path_cache_rechecks, path_cache_misses);
+    ur_send_line(buff);
+    sprintf(buff, "anytime - partial paths: %u, pending: %u, ticks: %u, finished in the loop: %u", path_anytime_partials, path_anytime_pending,
+            path_anytime_ticks, path_anytime_finished);
+    ur_send_line(buff);
+}
+
+// plans from (sx, sy) to (tx, ty), ox, oy are return values
+// returns sx, sy if no valid path found
+// returns tx, ty if the valid path is completely clear
+// returns the first waypoint to go to in the path otherwise
+void path_to(float sx, float sy, float tx, float ty, float *ox, float *oy) {
+    if (path_to_full(sx, sy, tx, ty, ox, oy, 1) == 0) {
+        *ox = sx;
+        *oy = sy;
+    }
+}
@@ -0,0 +1,327 @@
+#pragma once
+
+#include "main_scan_data.h"
+#include "main_scan_cache.h"
+#include "main_objects.h"
+#include "main_occupancy.h"
+#include "eeprom.h"
+#include "data_protocol.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+
+
+// ------------------------------ map persistence ------------------------------
+// saves the map, exploration heat map, pose and calibration to the eeprom so a power cycle doesn't start the bot blind
+// layout in words: magic, version << 16 | payload bytes, crc32 of the payload, then the payload packed little endian
+// the occupancy grid and scan cache are not saved, they are rebuilt from the first scans after a load
+
+#define PERSIST_MAGIC 0x434D4150 // "CMAP"
+#define PERSIST_VERSION 3 // bump whenever the payload layout changes, old saves are then ignored
+#define PERSIST_HEADER_WORDS 3
+
+// 1 to load the saved map right away at boot, otherwise only with the 'l' command
+#define PERSIST_LOAD_ON_BOOT 0
+
+// pose + cal + heat map + objects + segments, with room to spare
+#define PERSIST_MAX_BYTES (12 + 32 + (2 + (EXP_FINE_SLOTS + EXP_COARSE_SLOTS) * 12) + (1 + OBJECT_MAP_SIZE * 19) + (1 + SEGMENT_MAP_SIZE * 10))
+#define PERSIST_MAX_WORDS ((PERSIST_MAX_BYTES + 3) / 4)
+
+#if PERSIST_HEADER_WORDS + PERSIST_MAX_WORDS > EE_WORD_COUNT
+    #error "the map no longer fits in the eeprom, shrink the map or the saved fields"
+#endif
+
+// the payload is streamed to and from the eeprom a word at a time instead of going through a buffer the size of the whole
+// save, which would cost 2KB of ram for something that's used twice a run
+static uint32_t persist_word; // the word being filled (save) or read from (load)
+static int persist_offset; // bytes into the payload
+static uint32_t persist_crc;
+static char persist_failed; // an eeprom write failed somewhere in the save
+
+// crc32 (the zip one), a nibble at a time to keep the table small
+static inline uint32_t persist_crc_byte(uint32_t crc, uint8_t byte) {
+    static const uint32_t table[16] = {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+        0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+    };
+    crc = (crc >> 4) ^ table[(crc ^ byte) & 0x0F];
+    crc = (crc >> 4) ^ table[(crc ^ (byte >> 4)) & 0x0F];
+    return crc;
+}
+
+static void persist_start() {
+    persist_word = 0;
+    persist_offset = 0;
+    persist_crc = 0xFFFFFFFF;
+    persist_failed = 0;
+}
+
+// writes the word once it's full (or the last partial one, zero padded) after the header
+static void persist_flush() {
+    if (ee_write(PERSIST_HEADER_WORDS + (persist_offset - 1) / 4, &persist_word, 1)) persist_failed = 1;
+    persist_word = 0;
+}
+
+// bytes go in little endian, the same layout a memcpy into a word buffer gave
+static void persist_put(const void * value, int size) {
+    const uint8_t * bytes = value;
+    int i;
+    for (i = 0; i < size; i++) {
+        persist_word |= (uint32_t) bytes[i] << (8 * (persist_offset & 3));
+        persist_crc = persist_crc_byte(persist_crc, bytes[i]);
+        persist_offset++;
+        if ((persist_offset & 3) == 0) persist_flush();
+    }
+}
+static void persist_get(void * value, int size) {
+    uint8_t * bytes = value;
+    int i;
+    for (i = 0; i < size; i++) {
+        if ((persist_offset & 3) == 0) ee_read(PERSIST_HEADER_WORDS + persist_offset / 4, &persist_word, 1);
+        bytes[i] = persist_word >> (8 * (persist_offset & 3));
+        persist_crc = persist_crc_byte(persist_crc, bytes[i]);
+        persist_offset++;
+    }
+}
+static inline void persist_put_i16(float v) {
+    const int16_t i = (v > 32767) ? 32767 : ((v < -32768) ? -32768 : (int16_t) roundf(v));
+    persist_put(&i, 2);
+}
+static inline float persist_get_i16() {
+    int16_t i;
+    persist_get(&i, 2);
+    return i;
+}
+
+// heat map tiles, a count and then each tile's position and cells
+static void persist_put_exp_level(const exp_level * l) {
+    const uint8_t tile_c = l->count;
+    persist_put(&tile_c, 1);
+
+    int i;
+    for (i = 0; i < l->slots; i++) {
+        if (!l->tiles[i].used) continue;
+        persist_put(&l->tiles[i].tx, 2);
+        persist_put(&l->tiles[i].ty, 2);
+        persist_put(&l->tiles[i].cells, 8);
+    }
+}
+static void persist_get_exp_level(exp_level * l) {
+    uint8_t tile_c;
+    persist_get(&tile_c, 1);
+
+    int i;
+    for (i = 0; i < tile_c; i++) {
+        int16_t tx, ty;
+        uint64_t cells;
+        persist_get(&tx, 2);
+        persist_get(&ty, 2);
+        persist_get(&cells, 8);
+        exp_tile_get(l, tx, ty)->cells = cells;
+    }
+}
+
+// writes everything to the eeprom. returns 0 on success
+int persist_save() {
+    persist_start();
+
+    // pose
+    const float pose[3] = { get_pos_x(), get_pos_y(), get_pos_r() };
+    persist_put(pose, sizeof(pose));
+
+    // calibration
+    uint32_t sv_min, sv_max;
+    float sv_ms_per_deg, sv_settle_ms;
+    sv_get_cal(&sv_min, &sv_max);
+    sv_get_dynamics(&sv_ms_per_deg, &sv_settle_ms);
+    const Curve ir_curve = ir_get_model();
+
+    persist_put(&sv_min, 4);
+    persist_put(&sv_max, 4);
+    persist_put(&sv_ms_per_deg, 4);
+    persist_put(&sv_settle_ms, 4);
+    persist_put(&ir_curve.model, 1);
+    persist_put(&ir_curve.a, 4);
+    persist_put(&ir_curve.b, 4);
+
+    // exploration heat map
+    persist_put_exp_level(&exp_fine);
+    persist_put_exp_level(&exp_coarse);
+
+    // objects, mm as 16 bit and the variance as a std dev
+    int i;
+    const uint8_t obj_c = object_map_c;
+    persist_put(&obj_c, 1);
+    for (i = 0; i < object_map_c; i++) {
+        const object_positional *o = &object_map[i];
+        persist_put_i16(o->x);
+        persist_put_i16(o->y);
+        persist_put_i16(MIN(o->radius, 32767));
+        persist_put(&o->type, 1);
+        persist_put(&o->confidence, 1);
+        persist_put_i16(sqrtf(o->variance));
+
+        // classification evidence
+        persist_put(&o->seen, 1);
+        persist_put(&o->bumps, 1);
+        persist_put(&o->cliffs, 1);
+        persist_put(&o->class_confidence, 1);
+        persist_put(&o->range_disagree, 1);
+        persist_put(&o->width_mean, 2);
+        persist_put(&o->width_dev, 2);
+    }
+
+    // wall segments
+    const uint8_t seg_c = segment_map_c;
+    persist_put(&seg_c, 1);
+    for (i = 0; i < segment_map_c; i++) {
+        const wall_segment *s = &segment_map[i];
+        persist_put_i16(s->ax);
+        persist_put_i16(s->ay);
+        persist_put_i16(s->bx);
+        persist_put_i16(s->by);
+        persist_put(&s->type, 1);
+        persist_put(&s->support, 1);
+    }
+
+    if (persist_offset & 3) persist_flush();
+
+    const int length = persist_offset;
+    const uint32_t header[PERSIST_HEADER_WORDS] = {
+        PERSIST_MAGIC,
+        ((uint32_t) PERSIST_VERSION << 16) | length,
+        ~persist_crc
+    };
+
+    // payload first (it's already written), so a power loss mid save leaves a header that doesn't match and the save is
+    // ignored
+    if (persist_failed || ee_write(0, header, PERSIST_HEADER_WORDS)) {
+        ur_send_line("Warning: eeprom write failed, map not saved");
+        return -1;
+    }
+
+    char buff[64];
+    sprintf(buff, "map saved - %d bytes, %d objects, %d walls", length, object_map_c, segment_map_c);
+    ur_send_line(buff);
+    return 0;
+}
+
+// restores everything from the eeprom. returns 0 on success, nothing is changed if the save is missing or bad
+int persist_load() {
+    uint32_t header[PERSIST_HEADER_WORDS] = {0};
+    ee_read(0, header, PERSIST_HEADER_WORDS);
+
+    const int length = header[1] & 0xFFFF;
+    if (header[0] != PERSIST_MAGIC || (header[1] >> 16) != PERSIST_VERSION || length > PERSIST_MAX_BYTES) {
+        ur_send_line("no saved map (or it's from an older version)");
+        return -1;
+    }
+
+    // one pass for the crc so nothing is touched if it's bad, then read it again for real
+    persist_start();
+    int i;
+    for (i = 0; i < length; i++) {
+        uint8_t byte;
+        persist_get(&byte, 1);
+    }
+    if (~persist_crc != header[2]) {
+        ur_send_line("saved map is corrupt, ignoring it");
+        return -1;
+    }
+
+    persist_start();
+
+    // pose
+    float pose[3];
+    persist_get(pose, sizeof(pose));
+    set_pos(pose[0], pose[1], pose[2]);
+
+    // calibration
+    uint32_t sv_min, sv_max;
+    float sv_ms_per_deg, sv_settle_ms;
+    Curve ir_curve;
+    persist_get(&sv_min, 4);
+    persist_get(&sv_max, 4);
+    persist_get(&sv_ms_per_deg, 4);
+    persist_get(&sv_settle_ms, 4);
+    persist_get(&ir_curve.model, 1);
+    persist_get(&ir_curve.a, 4);
+    persist_get(&ir_curve.b, 4);
+
+    sv_set_cal_known(sv_min, sv_max);
+    sv_set_dynamics_known(sv_ms_per_deg, sv_settle_ms);
+    ir_set_model(ir_curve.model, ir_curve.a, ir_curve.b);
+
+    // exploration heat map
+    exp_map_clear();
+    persist_get_exp_level(&exp_fine);
+    persist_get_exp_level(&exp_coarse);
+
+    // objects
+    uint8_t obj_c;
+    persist_get(&obj_c, 1);
+
+    object_map_c = 0;
+    object_map_version++;
+    for (i = 0; i < obj_c; i++) {
+        const float x = persist_get_i16();
+        const float y = persist_get_i16();
+        const float r = persist_get_i16();
+        char type;
+        unsigned char confidence;
+        persist_get(&type, 1);
+        persist_get(&confidence, 1);
+        const float sigma = persist_get_i16();
+
+        object_positional evidence;
+        persist_get(&evidence.seen, 1);
+        persist_get(&evidence.bumps, 1);
+        persist_get(&evidence.cliffs, 1);
+        persist_get(&evidence.class_confidence, 1);
+        persist_get(&evidence.range_disagree, 1);
+        persist_get(&evidence.width_mean, 2);
+        persist_get(&evidence.width_dev, 2);
+
+        const int index = add_object_to_map(x, y, r, type, confidence);
+        if (index == -1) continue;
+
+        object_positional *o = &object_map[index];
+        o->variance = sigma * sigma;
+        o->seen = evidence.seen;
+        o->bumps = evidence.bumps;
+        o->cliffs = evidence.cliffs;
+        o->class_confidence = evidence.class_confidence;
+        o->range_disagree = evidence.range_disagree;
+        o->width_mean = evidence.width_mean;
+        o->width_dev = evidence.width_dev;
+    }
+
+    // wall segments
+    uint8_t seg_c;
+    persist_get(&seg_c, 1);
+
+    segment_map_c = 0;
+    for (i = 0; i < seg_c && i < SEGMENT_MAP_SIZE; i++) {
+        wall_segment *s = &segment_map[segment_map_c++];
+        s->ax = persist_get_i16();
+        s->ay = persist_get_i16();
+        s->bx = persist_get_i16();
+        s->by = persist_get_i16();
+        persist_get(&s->type, 1);
+        persist_get(&s->support, 1);
+    }
+    segment_map_version++;
+
+    // anything built from the old pose is stale
+    scan_cache_clear();
+    occ_clear();
+
+    char buff[64];
+    sprintf(buff, "map loaded - %d objects, %d walls", object_map_c, segment_map_c);
+    ur_send_line(buff);
+
+    send_data_packet(object_map, object_map_c, 1); // update python data packet
+    return 0;
+}
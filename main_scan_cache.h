@@ -0,0 +1,246 @@
+#pragma once
+
+#include "main_scan_data.h"
+#include "scan.h"
+#include "movement.h"
+#include "Timer.h"
+#include "uart.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// ------------------------------ scan cache ------------------------------
+// keeps the last few sweeps (ir and fused) along with the pose they were taken from. when a new sweep is asked for from about
+// the same spot, every angle any usable entry holds is copied from the cache (re-aligned for any turn) and only the rest is
+// actually swept. a window the cache fully covers is not swept at all
+// coverage is worked out per angle over all the entries, by scan_cache_cover, so scan_cache_find_uncovered and
+// scan_cache_sweep always agree on what is left to sweep
+
+#define SCAN_CACHE_SIZE 2
+#define SCAN_CACHE_MAX_DIST 50 // mm the bot can move before a cached sweep is no longer used
+#define SCAN_CACHE_MAX_TURN 120 // deg the bot can turn before a cached sweep is no longer used
+#define SCAN_CACHE_MAX_AGE 30000 // ms before a cached sweep is too old to trust
+#define SCAN_CACHE_EMPTY INT16_MIN // an angle the entry doesn't hold
+
+typedef struct scan_cache_entry {
+    float x, y, r; // pose of the bot when the sweep was taken
+    unsigned int time; // timer_getMillis when it was first swept
+    int resolution; // step size the samples were swept at
+    char valid;
+    int16_t data[SCAN_BUFFER_SIZE]; // mm, see scan_cache_pack. SCAN_CACHE_EMPTY where nothing was swept
+    int16_t fused[SCAN_BUFFER_SIZE];
+} scan_cache_entry;
+
+static scan_cache_entry scan_cache[SCAN_CACHE_SIZE];
+
+// counters for tuning, see scan_cache_print_stats
+unsigned int scan_cache_hits = 0; // windows fully served from the cache
+unsigned int scan_cache_partials = 0; // windows where only the new part was swept
+unsigned int scan_cache_misses = 0; // windows swept from scratch
+unsigned int scan_cache_points_swept = 0;
+unsigned int scan_cache_points_reused = 0;
+
+// samples are cm floats in the sweep buffers but only kept to the mm here, half the ram and well under the sensor noise.
+// SCAN_NO_DATA (1000 cm) comes back out exactly, anything out of range (or nan) is kept as the far end
+static inline int16_t scan_cache_pack(float cm) {
+    const float mm = roundf(cm * 10);
+    if (!(mm < 32767)) return 32767;
+    return (mm < -32767) ? -32767 : (int16_t) mm; // -32768 is SCAN_CACHE_EMPTY
+}
+static inline float scan_cache_unpack(int16_t mm) {
+    return mm / 10.0f;
+}
+
+// forget every cached sweep, for when the map or position is reset
+void scan_cache_clear() {
+    int i;
+    for (i = 0; i < SCAN_CACHE_SIZE; i++) scan_cache[i].valid = 0;
+}
+
+// the servo angle offset from the current heading to the heading the entry was swept at
+static int scan_cache_shift(const scan_cache_entry * e) {
+    int shift = roundf(get_pos_r() - e->r);
+    while (shift > 180)   shift -= 360;
+    while (shift <= -180) shift += 360;
+    return shift;
+}
+
+// 1 if the entry can be used from the current pose at this resolution
+static char scan_cache_usable(const scan_cache_entry * e, int resolution) {
+    if (!e->valid || e->resolution > resolution) return 0;
+    if (timer_getMillis() - e->time > SCAN_CACHE_MAX_AGE) return 0;
+    if (dist(e->x, e->y, get_pos_x(), get_pos_y()) > SCAN_CACHE_MAX_DIST) return 0;
+    return abs(scan_cache_shift(e)) <= SCAN_CACHE_MAX_TURN;
+}
+
+// for each servo angle in [start_angle, end_angle] sets source[angle / SCAN_RESOLUTION] to the usable entry that holds it
+// (the newest if more than one does) or -1, and shift to each entry's scan_cache_shift. returns the number of angles no
+// entry holds
+static int scan_cache_cover(int start_angle, int end_angle, int resolution, int8_t * source, int * shift) {
+    char usable[SCAN_CACHE_SIZE];
+    int i, s;
+    for (i = 0; i < SCAN_CACHE_SIZE; i++) {
+        usable[i] = scan_cache_usable(&scan_cache[i], resolution);
+        shift[i] = usable[i] ? scan_cache_shift(&scan_cache[i]) : 0;
+    }
+
+    int uncovered = 0;
+    for (s = start_angle; s <= end_angle; s += SCAN_RESOLUTION) {
+        int best = -1;
+        for (i = 0; i < SCAN_CACHE_SIZE; i++) {
+            const int k = s + shift[i];
+            if (!usable[i] || k < 0 || k > 180 || scan_cache[i].data[k / SCAN_RESOLUTION] == SCAN_CACHE_EMPTY) continue;
+            if (best == -1 || timer_getMillis() - scan_cache[i].time < timer_getMillis() - scan_cache[best].time) best = i;
+        }
+        source[s / SCAN_RESOLUTION] = best;
+        uncovered += best == -1;
+    }
+    return uncovered;
+}
+
+// 1 if the cache already covers all of [start_angle, end_angle] from about this pose
+char scan_cache_covers(int start_angle, int end_angle, int resolution) {
+    int8_t source[SCAN_BUFFER_SIZE];
+    int shift[SCAN_CACHE_SIZE];
+    return !scan_cache_cover(start_angle, end_angle, resolution, source, shift);
+}
+
+// shrinks the servo window [*start_angle, *end_angle] down to the span from the first to the last angle the cache can't
+// serve from the current pose (anything cached in between is reused by scan_cache_sweep). returns 0 if the whole window
+// is already cached
+char scan_cache_find_uncovered(int * start_angle, int * end_angle, int resolution) {
+    int8_t source[SCAN_BUFFER_SIZE];
+    int shift[SCAN_CACHE_SIZE];
+    if (!scan_cache_cover(*start_angle, *end_angle, resolution, source, shift)) return 0;
+
+    while (source[*start_angle / SCAN_RESOLUTION] != -1) *start_angle += SCAN_RESOLUTION;
+    while (source[*end_angle / SCAN_RESOLUTION] != -1)   *end_angle -= SCAN_RESOLUTION;
+    return 1;
+}
+
+// the actual sweep behind the cache
+static void scan_cache_sweep_raw(float * output, float * fused_output, int start_angle, int end_angle, int resolution) {
+#if SCAN_FUSED_SWEEP
+    sc_sweep_fused_sector(output, fused_output, start_angle, end_angle, resolution, SCAN_PING_EVERY);
+#else
+    sc_sweep_fused_sector(output, fused_output, start_angle, end_angle, resolution, 0);
+#endif
+}
+
+// a slot to store a new sweep in. an unused one, else the oldest that served none of this sweep, else the oldest
+static scan_cache_entry * scan_cache_slot(const char * served) {
+    scan_cache_entry * slot = NULL;
+    int i;
+    for (i = 0; i < SCAN_CACHE_SIZE; i++) {
+        scan_cache_entry * e = &scan_cache[i];
+        if (!e->valid) return e;
+        if (!slot || (served[slot - scan_cache] && !served[i])) slot = e;
+        else if (served[slot - scan_cache] == served[i] && timer_getMillis() - e->time > timer_getMillis() - slot->time) slot = e;
+    }
+    return slot;
+}
+
+// sweeps the servo window [start_angle, end_angle] into output and fused_output (see sc_sweep_fused_sector), reusing the cache where possible
+// angles outside the window are not touched. reused[angle / SCAN_RESOLUTION] is set to 1 for every angle copied from the
+// cache and 0 for the rest. returns 0 on a full cache hit (nothing new was swept), 1 otherwise
+// an entry only ever holds samples from its own pose and time. new samples are only added to an entry if the bot hasn't
+// moved since it was swept, otherwise they all go in one new entry, so the distance and age limits hold for every sample
+char scan_cache_sweep(float * output, float * fused_output, int start_angle, int end_angle, int resolution, char * reused) {
+    int8_t source[SCAN_BUFFER_SIZE];
+    int shift[SCAN_CACHE_SIZE];
+    int uncovered = scan_cache_cover(start_angle, end_angle, resolution, source, shift);
+    const int total = (end_angle - start_angle) / SCAN_RESOLUTION + 1;
+
+    char served[SCAN_CACHE_SIZE] = {0};
+    int s, i;
+    for (s = start_angle; s <= end_angle; s += SCAN_RESOLUTION) {
+        if (source[s / SCAN_RESOLUTION] != -1) served[source[s / SCAN_RESOLUTION]] = 1;
+    }
+
+    // where the new samples will go, an entry swept from right here if there is one (it keeps its time, the age of its
+    // oldest samples), otherwise a new one. if that has to replace an entry serving part of this window, that part is swept
+    // again too, so the whole window is cached afterwards and scan_cache_find_uncovered has nothing left to ask for
+    scan_cache_entry * e = NULL;
+    int target = -1;
+    if (uncovered) {
+        for (i = 0; i < SCAN_CACHE_SIZE; i++) {
+            const scan_cache_entry * c = &scan_cache[i];
+            if (scan_cache_usable(c, resolution) && shift[i] == 0 && dist(c->x, c->y, get_pos_x(), get_pos_y()) < 1) target = i;
+        }
+
+        if (target == -1) {
+            e = scan_cache_slot(served);
+            if (served[e - scan_cache]) {
+                for (s = start_angle; s <= end_angle; s += SCAN_RESOLUTION) {
+                    if (source[s / SCAN_RESOLUTION] == e - scan_cache) {
+                        source[s / SCAN_RESOLUTION] = -1;
+                        uncovered++;
+                    }
+                }
+            }
+        }
+        else e = &scan_cache[target];
+    }
+
+    // copy over everything the cache has
+    for (s = 0; s <= 180; s += SCAN_RESOLUTION) reused[s / SCAN_RESOLUTION] = 0;
+    for (s = start_angle; s <= end_angle; s += SCAN_RESOLUTION) {
+        i = source[s / SCAN_RESOLUTION];
+        if (i == -1) continue;
+        output[s / SCAN_RESOLUTION] = scan_cache_unpack(scan_cache[i].data[(s + shift[i]) / SCAN_RESOLUTION]);
+        fused_output[s / SCAN_RESOLUTION] = scan_cache_unpack(scan_cache[i].fused[(s + shift[i]) / SCAN_RESOLUTION]);
+        reused[s / SCAN_RESOLUTION] = 1;
+    }
+
+    scan_cache_points_reused += total - uncovered;
+    scan_cache_points_swept += uncovered;
+
+    if (!uncovered) {
+        scan_cache_hits++;
+        return 0;
+    }
+    if (uncovered == total) scan_cache_misses++;
+    else                    scan_cache_partials++;
+
+    // sweep each run the cache didn't have
+    int run_start = -1;
+    for (s = start_angle; s <= end_angle + SCAN_RESOLUTION; s += SCAN_RESOLUTION) {
+        const char missing = s <= end_angle && source[s / SCAN_RESOLUTION] == -1;
+        if (missing && run_start == -1) run_start = s;
+        if (!missing && run_start != -1) {
+            scan_cache_sweep_raw(output, fused_output, run_start, s - SCAN_RESOLUTION, resolution);
+            run_start = -1;
+        }
+    }
+
+    // and keep them
+    if (target == -1) {
+        for (s = 0; s <= 180; s += SCAN_RESOLUTION) e->data[s / SCAN_RESOLUTION] = e->fused[s / SCAN_RESOLUTION] = SCAN_CACHE_EMPTY;
+        e->x = get_pos_x();
+        e->y = get_pos_y();
+        e->r = get_pos_r();
+        e->time = timer_getMillis();
+        e->resolution = resolution;
+        e->valid = 1;
+    }
+    e->resolution = MAX(resolution, e->resolution);
+
+    for (s = start_angle; s <= end_angle; s += SCAN_RESOLUTION) {
+        if (source[s / SCAN_RESOLUTION] != -1) continue;
+        e->data[s / SCAN_RESOLUTION] = scan_cache_pack(output[s / SCAN_RESOLUTION]);
+        e->fused[s / SCAN_RESOLUTION] = scan_cache_pack(fused_output[s / SCAN_RESOLUTION]);
+    }
+
+    return 1;
+}
+
+// prints the hit/miss counters
+void scan_cache_print_stats() {
+    char buff[96];
+    sprintf(buff, "scan cache - hits: %u, partial: %u, misses: %u", scan_cache_hits, scan_cache_partials, scan_cache_misses);
+    ur_send_line(buff);
+    sprintf(buff, "scan cache - points swept: %u, points reused: %u", scan_cache_points_swept, scan_cache_points_reused);
+    ur_send_line(buff);
+}
@@ -1,23 +1,41 @@
-#pragma once
-
-
-
-
-// 1 degree increments, 181 data points
-#define SCAN_BUFFER_SIZE (180 / SCAN_RESOLUTION + 1)
-
-// only allow objects up to x cm away
-#define SCAN_MAX_DISTANCE 70
-
-// scan data buffers
-float data[SCAN_BUFFER_SIZE];
-
-// object radial storage (small temp)
-object_radial objects[8];
-int objects_c;
-
-// object map (xy based)
-object_positional object_map[64];
-int object_map_c;
-
-
+#pragma once
+
+
+
+
+// 1 degree increments, 181 data points
+#define SCAN_BUFFER_SIZE (180 / SCAN_RESOLUTION + 1)
+
+// only allow objects up to x cm away
+#define SCAN_MAX_DISTANCE 70
+
+// scan data buffers, ir and ir fused with ping
+float data[SCAN_BUFFER_SIZE];
+float fused_data[SCAN_BUFFER_SIZE];
+
+// 1 to ping during the ir sweep and take object distances from the fused data, 0 to re-ping each object after the sweep
+#define SCAN_FUSED_SWEEP 1
+
+// object radial storage (small temp)
+object_radial objects[8];
+int objects_c;
+
+// object map (xy based)
+#define OBJECT_MAP_SIZE 64
+object_positional object_map[OBJECT_MAP_SIZE];
+int object_map_c;
+
+// bumped whenever an object is added, removed, moved, resized or becomes or stops being a sure hazard. anything built from
+// the map (like the pathfinding index) checks it to know when to rebuild. evidence, confidence and last_seen don't bump it
+unsigned int object_map_version = 0;
+
+// straight walls and the border as line segments, see main_segments.h
+#define SEGMENT_MAP_SIZE 16
+wall_segment segment_map[SEGMENT_MAP_SIZE];
+int segment_map_c;
+unsigned int segment_map_version = 0;
+
+
+
+// fill value for scan buffer points outside of a sector scan, far enough to never become an object
+#define SCAN_NO_DATA 1000.0f
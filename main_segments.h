@@ -0,0 +1,287 @@
+#pragma once
+
+#include "main_scan_data.h"
+#include "scan.h"
+#include "movement.h"
+
+#include <math.h>
+#include <stdint.h>
+
+
+
+// ------------------------------ wall segments ------------------------------
+// straight walls are kept as line segments in segment_map instead of circles. the white border is built up from cliff hits,
+// each one is a short piece of line across where the bot touched the tape, merged and refit with any piece it lines up with
+// long flat stretches of a sweep are found with split-and-merge and stored the same way
+
+#define SEG_MERGE_COS 0.966f // cos of 15 deg, segments more parallel than this can merge
+#define SEG_MERGE_DIST 80.0f // mm the new segment's ends can be off the old line
+#define SEG_MERGE_GAP 200.0f // mm of gap along the line that still merges
+
+#define SEG_CLIFF_HALF_LEN 300.0f // mm each side of a cliff hit the border piece covers
+
+#define SEG_SPLIT_TOLERANCE 30.0f // mm a sweep point can be off the line before it is split there
+#define SEG_RUN_GAP 5.0f // cm jump between sweep samples that breaks a run
+#define SEG_MIN_POINTS 12 // samples a line needs
+#define SEG_MIN_LEN 300.0f // mm a line needs, shorter flats are objects
+
+// a segment's direction and length
+static inline void segment_dir(const wall_segment * s, float * ux, float * uy, float * len) {
+    const float dx = s->bx - s->ax;
+    const float dy = s->by - s->ay;
+    *len = sqrtf(dx * dx + dy * dy);
+    *ux = *len > 0 ? dx / *len : 1;
+    *uy = *len > 0 ? dy / *len : 0;
+}
+
+// tries to merge (ax, ay)-(bx, by) into segment at index, refitting it through both. returns 1 if it merged
+static char segment_try_merge(int index, float ax, float ay, float bx, float by, char type) {
+    wall_segment * s = &segment_map[index];
+    if (s->type != type) return 0;
+
+    float ux, uy, len;
+    segment_dir(s, &ux, &uy, &len);
+
+    float nux, nuy, nlen;
+    const wall_segment n = { ax, ay, bx, by, type, 1 };
+    segment_dir(&n, &nux, &nuy, &nlen);
+
+    // parallel enough. borders keep their outside on the right so they can't flip, scanned walls can
+    float c = ux * nux + uy * nuy;
+    if (type != 3 && c < 0) {
+        float t;
+        t = ax; ax = bx; bx = t;
+        t = ay; ay = by; by = t;
+        nux = -nux;
+        nuy = -nuy;
+        c = -c;
+    }
+    if (c < SEG_MERGE_COS) return 0;
+
+    // close to the old line
+    const float da = fabsf((ax - s->ax) * uy - (ay - s->ay) * ux);
+    const float db = fabsf((bx - s->ax) * uy - (by - s->ay) * ux);
+    if (da > SEG_MERGE_DIST || db > SEG_MERGE_DIST) return 0;
+
+    // overlapping or a small gap along it
+    const float ta = (ax - s->ax) * ux + (ay - s->ay) * uy;
+    const float tb = (bx - s->ax) * ux + (by - s->ay) * uy;
+    if (MIN(ta, tb) > len + SEG_MERGE_GAP || MAX(ta, tb) < -SEG_MERGE_GAP) return 0;
+
+    // refit, direction and center weighted by how much each one has been seen
+    const float w_old = s->support;
+    float fx = ux * w_old + nux;
+    float fy = uy * w_old + nuy;
+    const float flen = sqrtf(fx * fx + fy * fy);
+    fx /= flen;
+    fy /= flen;
+
+    const float cx = ((s->ax + s->bx) * w_old + (ax + bx)) / (2 * (w_old + 1));
+    const float cy = ((s->ay + s->by) * w_old + (ay + by)) / (2 * (w_old + 1));
+
+    // new extent is everything either covered
+    const float t0 = (s->ax - cx) * fx + (s->ay - cy) * fy;
+    const float t1 = (s->bx - cx) * fx + (s->by - cy) * fy;
+    const float t2 = (ax - cx) * fx + (ay - cy) * fy;
+    const float t3 = (bx - cx) * fx + (by - cy) * fy;
+    const float t_min = MIN(MIN(t0, t1), MIN(t2, t3));
+    const float t_max = MAX(MAX(t0, t1), MAX(t2, t3));
+
+    s->ax = cx + fx * t_min;
+    s->ay = cy + fy * t_min;
+    s->bx = cx + fx * t_max;
+    s->by = cy + fy * t_max;
+    if (s->support < 255) s->support++;
+
+    return 1;
+}
+
+// adds a wall segment, merging it into one it lines up with. type 3 is the white border, with the outside on the right of a to b
+// returns the index it ended up at, or -1 if the store was full
+int add_wall_segment(float ax, float ay, float bx, float by, char type) {
+    int i;
+    for (i = 0; i < segment_map_c; i++) {
+        if (segment_try_merge(i, ax, ay, bx, by, type)) {
+            // the refit can now line up with another one, fold that in too
+            int j;
+            for (j = 0; j < segment_map_c; j++) {
+                if (j == i) continue;
+
+                const wall_segment o = segment_map[j];
+                if (segment_try_merge(i, o.ax, o.ay, o.bx, o.by, o.type)) {
+                    segment_map[i].support = MIN(255, segment_map[i].support + o.support - 1);
+                    segment_map[j] = segment_map[--segment_map_c];
+                    if (i == segment_map_c) i = j; // it was the one moved
+                    j = -1;
+                }
+            }
+
+            segment_map_version++;
+            return i;
+        }
+    }
+
+    if (segment_map_c >= SEGMENT_MAP_SIZE) {
+        // drop the least seen scanned wall, the border is kept
+        int drop = -1;
+        for (i = 0; i < segment_map_c; i++) {
+            if (segment_map[i].type == 3) continue;
+            if (drop == -1 || segment_map[i].support < segment_map[drop].support) drop = i;
+        }
+
+        if (drop == -1) {
+            ur_send_line("Warning: segment store full, wall dropped");
+            return -1;
+        }
+        segment_map[drop] = segment_map[--segment_map_c];
+    }
+
+    segment_map[segment_map_c] = (wall_segment) { ax, ay, bx, by, type, 1 };
+    segment_map_version++;
+    return segment_map_c++;
+}
+
+// adds a piece of white border where the bot hit it. cliff_angle (rad) points from the bot to the tape
+void add_border_from_cliff(float cliff_angle) {
+    const float c = cosf(cliff_angle);
+    const float s = sinf(cliff_angle);
+
+    // the tape is across the front of the bot, outside is away from it
+    const float ex = get_pos_x() + c * 160;
+    const float ey = get_pos_y() + s * 160;
+
+    add_wall_segment(ex + s * SEG_CLIFF_HALF_LEN, ey - c * SEG_CLIFF_HALF_LEN, ex - s * SEG_CLIFF_HALF_LEN, ey + c * SEG_CLIFF_HALF_LEN, (char) 3);
+}
+
+
+
+// split-and-merge over a sweep. scratch for the sweep points relative to the scanner, mm
+static int16_t seg_pts_x[SCAN_BUFFER_SIZE];
+static int16_t seg_pts_y[SCAN_BUFFER_SIZE];
+
+// total least squares line through points [s, e], returned as the two ends projected onto it
+static void seg_fit(int s, int e, float * ax, float * ay, float * bx, float * by) {
+    const int n = e - s + 1;
+
+    float mx = 0, my = 0;
+    int i;
+    for (i = s; i <= e; i++) {
+        mx += seg_pts_x[i];
+        my += seg_pts_y[i];
+    }
+    mx /= n;
+    my /= n;
+
+    float sxx = 0, syy = 0, sxy = 0;
+    for (i = s; i <= e; i++) {
+        const float dx = seg_pts_x[i] - mx;
+        const float dy = seg_pts_y[i] - my;
+        sxx += dx * dx;
+        syy += dy * dy;
+        sxy += dx * dy;
+    }
+
+    // direction of most spread
+    const float theta = 0.5f * atan2f(2 * sxy, sxx - syy);
+    const float ux = cosf(theta);
+    const float uy = sinf(theta);
+
+    const float t0 = (seg_pts_x[s] - mx) * ux + (seg_pts_y[s] - my) * uy;
+    const float t1 = (seg_pts_x[e] - mx) * ux + (seg_pts_y[e] - my) * uy;
+
+    *ax = mx + ux * t0;
+    *ay = my + uy * t0;
+    *bx = mx + ux * t1;
+    *by = my + uy * t1;
+}
+
+// finds the straight walls in a sweep (cm, indexed by servo angle / SCAN_RESOLUTION) over the servo window [start_angle, end_angle]
+// and adds them to segment_map. the sweep samples each wall covers are set in used so they don't also become objects
+// returns the number of walls found
+int extract_wall_segments(float * ranges, int start_angle, int end_angle, char * used) {
+    const float r = get_pos_r() * (M_PI / 180);
+    const float sx = get_pos_x() + 90 * cosf(r);
+    const float sy = get_pos_y() + 90 * sinf(r);
+
+    const int first = start_angle / SCAN_RESOLUTION;
+    const int last = end_angle / SCAN_RESOLUTION;
+
+    int i;
+    for (i = first; i <= last; i++) {
+        used[i] = 0;
+        if (ranges[i] > SCAN_MAX_DISTANCE) continue;
+
+        const float angle = r + (i * SCAN_RESOLUTION + SWEEP_ANGLE_COMP - 90) * (M_PI / 180);
+        seg_pts_x[i] = ranges[i] * 10 * cosf(angle);
+        seg_pts_y[i] = ranges[i] * 10 * sinf(angle);
+    }
+
+    // split stack
+    int16_t stack_s[16];
+    int16_t stack_e[16];
+    int found = 0;
+
+    int run_start = first;
+    for (i = first; i <= last + 1; i++) {
+        // runs of in range samples without a jump
+        if (i <= last && ranges[i] <= SCAN_MAX_DISTANCE && (i == run_start || fabsf(ranges[i] - ranges[i - 1]) < SEG_RUN_GAP)) continue;
+
+        int top = 0;
+        if (i - run_start >= SEG_MIN_POINTS) {
+            stack_s[top] = run_start;
+            stack_e[top] = i - 1;
+            top++;
+        }
+
+        while (top > 0) {
+            top--;
+            const int s = stack_s[top];
+            const int e = stack_e[top];
+
+            // farthest point off the chord
+            const float cx = seg_pts_x[e] - seg_pts_x[s];
+            const float cy = seg_pts_y[e] - seg_pts_y[s];
+            const float clen = sqrtf(cx * cx + cy * cy);
+            if (clen < SEG_MIN_LEN) continue;
+
+            int worst = -1;
+            float worst_off = SEG_SPLIT_TOLERANCE;
+            int k;
+            for (k = s + 1; k < e; k++) {
+                const float off = fabsf((seg_pts_x[k] - seg_pts_x[s]) * cy - (seg_pts_y[k] - seg_pts_y[s]) * cx) / clen;
+                if (off > worst_off) {
+                    worst = k;
+                    worst_off = off;
+                }
+            }
+
+            if (worst != -1) {
+                // split, both halves still need enough points
+                if (worst - s + 1 >= SEG_MIN_POINTS && top < 16) {
+                    stack_s[top] = s;
+                    stack_e[top] = worst;
+                    top++;
+                }
+                if (e - worst + 1 >= SEG_MIN_POINTS && top < 16) {
+                    stack_s[top] = worst;
+                    stack_e[top] = e;
+                    top++;
+                }
+                continue;
+            }
+
+            // straight enough, it's a wall
+            float ax, ay, bx, by;
+            seg_fit(s, e, &ax, &ay, &bx, &by);
+            if (add_wall_segment(sx + ax, sy + ay, sx + bx, sy + by, (char) 1) != -1) {
+                for (k = s; k <= e; k++) used[k] = 1;
+                found++;
+            }
+        }
+
+        // the next run starts at the sample that broke this one, if it's usable
+        run_start = (i <= last && ranges[i] <= SCAN_MAX_DISTANCE) ? i : i + 1;
+    }
+
+    return found;
+}
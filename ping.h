@@ -1,7 +1,27 @@
-#pragma once
-
-// init gpio and timer 3b for ping sensor
-void pn_init();
-
-// performs a ping. blocking. returns the float dist
-float pb_get_dist();
+#pragma once
+
+// init gpio and timer 3b for ping sensor
+void pn_init();
+
+// performs a ping. blocking, up to PING_TIMEOUT_US. returns the float dist, or PING_OUT_OF_RANGE
+float pb_get_dist();
+
+// anything further than this is reported as out of range
+#define PING_MAX_RANGE_CM 300.0f
+
+// distance value returned when no echo came back within PING_TIMEOUT_US
+#define PING_OUT_OF_RANGE (-1.0f)
+
+// round trip time for PING_MAX_RANGE_CM plus the sensor's trigger holdoff
+#define PING_TIMEOUT_US 20000
+
+// sends a ping and returns right away
+void pb_ping_start();
+
+// returns 0 while the ping started by pb_ping_start is still waiting on its echo
+// otherwise returns 1 and writes the distance to dist, PING_OUT_OF_RANGE if it timed out or was past max range
+char pb_ping_poll(float * dist);
+
+// set a function to be called (from the interrupt) with the distance when an echo completes. NULL to disable
+// timeouts are only seen by pb_ping_poll
+void pb_ping_set_callback(void (*callback)(float dist));
@@ -1,218 +1,560 @@
-#include <stdio.h>
-#include <string.h>
-#include <stdlib.h>
-#include <math.h>
-
-#include "scan.h"
-#include "Timer.h"
-
-#include "uart.h"
-#include "ir.h"
-#include "ping.h"
-#include "servo.h"
-#include "sound.h"
-
-
-
-// point the servo
-void sc_point_servo(int angle) {
-    sv_set_angle(angle);
-}
-
-
-
-// sweep scan with ping sensor, 2 deg increment. populates float array of minimum length 91.
-void sc_sweep_sound(float output[180 / SCAN_RESOLUTION + 1]) {
-    int i;
-    for (i = 0; i <= 180; i += SCAN_RESOLUTION) {
-        sc_point_servo(i);
-        output[i / SCAN_RESOLUTION] = pb_get_dist();
-    }
-}
-
-// performs a ping at an angle
-float sc_scan_sound(int angle) {
-    sc_point_servo(angle);
-
-
-    volatile float a = pb_get_dist();
-//    volatile float b = pb_get_dist();
-//    volatile float c = pb_get_dist();
-
-    // make a silly sound
-    sound_beep();
-
-//    if (b < a < c || c < a < b) return a;
-//    if (a < b < c || c < b < a) return b;
-//    return c;
-
-//
-    return a;
-}
-
-// sweep scan with ir sensor, 2 deg increment. populates int array of minimum length 91 with RAW VALUES.
-void sc_sweep_ir(float output[180 / SCAN_RESOLUTION + 1]) {
-    int i;
-    for (i = 0; i <= 180; i += SCAN_RESOLUTION) {
-        sv_set_angle(i);
-        int ir_raw_val = ir_floor_sample();
-        output[i / SCAN_RESOLUTION] = ir_raw_to_cm(ir_raw_val);
-    }
-}
-
-
-// get an individual ir scan value, raw
-// angle input 0-180
-int sc_scan_ir(int angle) {
-    sc_point_servo(angle);
-    return ir_floor_sample();
-}
-
-// print sweep scan
-void sc_print_sweep(float * data, int data_c) {
-    ur_send_line("Angle(Degrees)   Distance(m)");
-
-    int i;
-    for (i = 0; i < data_c; i++) {
-        char buff[64];
-        sprintf(buff, "%-16d%.1f", i * SCAN_RESOLUTION, data[i]);
-        ur_send_line(buff);
-    }
-}
-
-// print sweep scan with int values, assumes 2 deg increment
-void sc_print_sweep_raw(int * data, int data_c) {
-    ur_send_line("Angle(Degrees)   raw");
-
-    int i;
-    for (i = 0; i < data_c; i++) {
-        char buff[64];
-        sprintf(buff, "%-17d%d", i * SCAN_RESOLUTION, data[i]);
-        ur_send_line(buff);
-    }
-}
-
-
-
-// clean up a scan
-void sc_clean_scan(float * data, int data_c) {
-    int sweep_range = 4;
-    while (sweep_range >= 3) { // multipass,
-        int i;
-        for (i = 0; i < data_c - sweep_range; i++) {
-
-            float edge_far = data[i];
-            float edge_close = data[i + sweep_range - 1];
-
-            if (edge_far < edge_close) { // swap if close is further than far
-                float temp = edge_far;
-                edge_far = edge_close;
-                edge_close = temp;
-            }
-
-            int j;
-            for (j = 1; j < sweep_range - 1; j++) { // for each of the middle values, if they are too far out of range adjust them
-                if (data[i + j] > edge_far + 2) data[i + j] = edge_far;
-                if (data[i + j] < edge_close - 2) data[i + j] = edge_close;
-            }
-
-        }
-
-        sweep_range--;
-    }
-}
-
-
-
-
-// pass the scan data (ideally after sc_clean_scan was called)
-// populates objects and objects_c, finding objects within the max distance
-// filters objects with a rad smaller than min_rad
-#define MARCH_EDGE_TOLERANCE 10
-
-
-
-// algorithm for processing raw ir data and adding them to object radial map objects
-void sc_find_objects(float * data, int data_c, float max_distance, int min_rad, object_radial * objects, int * objects_c) { 
-    float march_min = data[0]; // we follow the line, allowing it to expand slowly for "diagonal" objects
-    float march_max = data[0];
-
-    int march_start = 0; // the start of the march in deg
-
-    int i;
-    for (i = 1; i < data_c; i++) {
-        if (data[i] > march_max + MARCH_EDGE_TOLERANCE || data[i] < march_min - MARCH_EDGE_TOLERANCE || i == data_c - 1) { // next step not within 5 units or end of scan, end march
-            int march_length = i - march_start;
-            float march_dist = (march_min + march_max) / 2; // innacurate, but good enough approx of object dist (for now)
-
-            if (
-                    march_length >= (min_rad / SCAN_RESOLUTION) && march_dist <= max_distance && // found an object within our constraints
-                    march_start > (2 / SCAN_RESOLUTION) && (march_start + march_length) < (180 - (2 / SCAN_RESOLUTION)) // object isn't on the very edge of the scan
-            ) {
-                objects[*objects_c].angle = (march_start + (march_length / 2)) * SCAN_RESOLUTION + SWEEP_ANGLE_COMP;
-                objects[*objects_c].diameter = march_length * SCAN_RESOLUTION;
-                objects[*objects_c].distance = march_dist;
-                
-                (*objects_c)++;
-            }
-
-            if (i != data_c - 1) { // reset for new march
-                march_min = data[i+1];
-                march_max = data[i+1];
-                march_start = i;
-            }
-        } else {
-            if      (data[i] > march_max) march_max = data[i]; // expand the scope of the march
-            else if (data[i] < march_min) march_min = data[i];
-        }
-    }
-
-}
-
-// prints out the data from sc_find_objects
-void sc_print_objects(object_radial * objects, int objects_c) {
-    ur_send_line("Object  Angle  Distance  angluar  size");
-
-    int i;
-    for (i = 0; i < objects_c; i++) {
-        char buff[64];
-        sprintf(buff, "%-8d%-7d%-10.2f%-10d%.2f", i, objects[i].angle, objects[i].distance, objects[i].diameter, objects[i].size);
-        ur_send_line(buff);
-    }
-}
-
-
-
-// refinds the distances to objects with the ping sensor
-void sc_reping_objects(object_radial * objects, int objects_c) {
-    int i;
-    for (i = 0; i < objects_c; i++) {
-
-        // get accurate distance measurement
-        float dist = sc_scan_sound(objects[i].angle);
-
-        // update the object
-        objects[i].distance = dist;
-
-    }
-}
-
-// populates the size property of the objects
-// requires the angular radius and distance to be accurate. it's recommended to use an ir sweep scan and then reping objects before calling this.
-void sc_calc_size_objects(object_radial * objects, int objects_c) {
-    int i;
-    for (i = 0; i < objects_c; i++) {
-
-        // update the object
-        objects[i].size = objects[i].distance * (objects[i].diameter * M_PI) / 180.0f; // rough approximation
-
-    }
-}
-
-
-
-
-
-
-
-
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "scan.h"
+#include "Timer.h"
+
+#include "uart.h"
+#include "ir.h"
+#include "ping.h"
+#include "servo.h"
+#include "sound.h"
+
+
+
+// point the servo
+void sc_point_servo(int angle) {
+    sv_set_angle(angle);
+}
+
+
+
+// sweep scan with ping sensor, 2 deg increment. populates float array of minimum length 91.
+// each ping's echo is waited on while the servo is already moving to the next angle
+void sc_sweep_sound(float output[180 / SCAN_RESOLUTION + 1]) {
+    int pending = -1; // the angle of the ping still in flight
+
+    int i;
+    for (i = 0; i <= 180; i += SCAN_RESOLUTION) {
+        sv_start_angle(i);
+
+        if (pending >= 0) {
+            while (!pb_ping_poll(&output[pending / SCAN_RESOLUTION])) /* noop */ ;
+        }
+
+        sv_wait_settled();
+
+        pb_ping_start();
+        pending = i;
+    }
+
+    while (!pb_ping_poll(&output[pending / SCAN_RESOLUTION])) /* noop */ ;
+}
+
+// performs a ping at an angle
+float sc_scan_sound(int angle) {
+    sc_point_servo(angle);
+
+
+    volatile float a = pb_get_dist();
+//    volatile float b = pb_get_dist();
+//    volatile float c = pb_get_dist();
+
+    // make a silly sound
+    sound_beep();
+
+//    if (b < a < c || c < a < b) return a;
+//    if (a < b < c || c < b < a) return b;
+//    return c;
+
+//
+    return a;
+}
+
+// sweep scan with ir sensor, 2 deg increment. populates int array of minimum length 91 with RAW VALUES.
+void sc_sweep_ir(float output[180 / SCAN_RESOLUTION + 1]) {
+    sc_sweep_ir_sector(output, 0, 180, SCAN_RESOLUTION);
+}
+
+// sweep scan with ir sensor over a window of the front arc. skipped angles hold the last sample so the buffer stays 1 point per SCAN_RESOLUTION
+void sc_sweep_ir_sector(float output[180 / SCAN_RESOLUTION + 1], int start_angle, int end_angle, int resolution) {
+    sc_sweep_fused_sector(output, NULL, start_angle, end_angle, resolution, 0);
+}
+
+// one pass sweep of both sensors. the ir burst and ping are started together once the servo is in place,
+// the burst is reduced and the echo collected while the servo moves on to the next angle
+void sc_sweep_fused_sector(float ir_output[180 / SCAN_RESOLUTION + 1], float fused_output[180 / SCAN_RESOLUTION + 1], int start_angle, int end_angle, int resolution, int ping_every) {
+    if (start_angle < 0) start_angle = 0;
+    if (end_angle > 180) end_angle = 180;
+    if (resolution < SCAN_RESOLUTION) resolution = SCAN_RESOLUTION;
+    if (fused_output == NULL) ping_every = 0;
+
+    unsigned char pinged[(180 / SCAN_RESOLUTION + 1 + 7) / 8] = {0}; // bit set for each angle that has a real ping
+    int pending = -1; // the angle of the last burst
+    int ping_pending = -1; // the angle of the ping in flight
+    int step = 0;
+
+    int i;
+    for (i = start_angle; i <= end_angle; i += SCAN_RESOLUTION) {
+        // only move the servo on resolution steps, and always on the last point of the window
+        if ((i - start_angle) % resolution != 0 && i + SCAN_RESOLUTION <= end_angle) continue;
+
+        sv_start_angle(i);
+
+        // process the previous point while the servo is moving, skipped angles hold its value
+        if (pending >= 0) {
+            const float value = ir_raw_to_cm(ir_burst_reduce(SCAN_IR_REDUCE));
+            for (; pending < i; pending += SCAN_RESOLUTION) ir_output[pending / SCAN_RESOLUTION] = value;
+        }
+        if (ping_pending >= 0) {
+            while (!pb_ping_poll(&fused_output[ping_pending / SCAN_RESOLUTION])) /* noop */ ;
+            pinged[(ping_pending / SCAN_RESOLUTION) / 8] |= 1 << ((ping_pending / SCAN_RESOLUTION) % 8);
+            ping_pending = -1;
+        }
+
+        sv_wait_settled();
+
+        // sample this point
+        ir_burst_start();
+        if (ping_every > 0 && step % ping_every == 0) {
+            pb_ping_start();
+            ping_pending = i;
+        }
+        while (!ir_burst_ready()) /* noop */ ;
+        pending = i;
+        step++;
+    }
+
+    if (pending >= 0) ir_output[pending / SCAN_RESOLUTION] = ir_raw_to_cm(ir_burst_reduce(SCAN_IR_REDUCE));
+    if (ping_pending >= 0) {
+        while (!pb_ping_poll(&fused_output[ping_pending / SCAN_RESOLUTION])) /* noop */ ;
+        pinged[(ping_pending / SCAN_RESOLUTION) / 8] |= 1 << ((ping_pending / SCAN_RESOLUTION) % 8);
+    }
+
+    if (fused_output == NULL) return;
+
+    // angles without their own ping take the nearest one, the ping beam is much wider than the gap anyway
+    for (i = start_angle; i <= end_angle; i += SCAN_RESOLUTION) {
+        const int n = i / SCAN_RESOLUTION;
+        if (pinged[n / 8] & (1 << (n % 8))) continue;
+
+        float ping = PING_OUT_OF_RANGE;
+        int d;
+        for (d = 1; d <= ping_every * resolution / SCAN_RESOLUTION; d++) {
+            if (n - d >= start_angle / SCAN_RESOLUTION && (pinged[(n - d) / 8] & (1 << ((n - d) % 8)))) { ping = fused_output[n - d]; break; }
+            if (n + d <= end_angle / SCAN_RESOLUTION && (pinged[(n + d) / 8] & (1 << ((n + d) % 8)))) { ping = fused_output[n + d]; break; }
+        }
+        fused_output[n] = ping;
+    }
+
+    // fuse them
+    for (i = start_angle; i <= end_angle; i += SCAN_RESOLUTION) {
+        fused_output[i / SCAN_RESOLUTION] = sc_fuse_ranges(ir_output[i / SCAN_RESOLUTION], fused_output[i / SCAN_RESOLUTION]);
+    }
+}
+
+// inverse variance weighted ir and ping distance. the ir variance comes from the slope of the calibrated ir curve
+// at that distance. if the two disagree by more than the gate, the ping is probably hearing something else in its
+// wide beam, so the narrow ir beam wins
+float sc_fuse_ranges(float ir_cm, float ping_cm) {
+    if (ping_cm == PING_OUT_OF_RANGE) return ir_cm;
+
+    const float ir_sigma = ir_cm_sigma(ir_cm);
+    const float var_ir = ir_sigma * ir_sigma;
+    const float var_ping = FUSE_PING_SIGMA * FUSE_PING_SIGMA;
+
+    if (fabsf(ir_cm - ping_cm) > FUSE_GATE * sqrtf(var_ir + var_ping)) return ir_cm;
+
+    return (ir_cm * var_ping + ping_cm * var_ir) / (var_ir + var_ping);
+}
+
+
+// get an individual ir scan value, raw
+// angle input 0-180
+int sc_scan_ir(int angle) {
+    sc_point_servo(angle);
+    return ir_floor_sample();
+}
+
+// print sweep scan
+void sc_print_sweep(float * data, int data_c) {
+    ur_send_line("Angle(Degrees)   Distance(m)");
+
+    int i;
+    for (i = 0; i < data_c; i++) {
+        char buff[64];
+        sprintf(buff, "%-16d%.1f", i * SCAN_RESOLUTION, data[i]);
+        ur_send_line(buff);
+    }
+}
+
+// print sweep scan with int values, assumes 2 deg increment
+void sc_print_sweep_raw(int * data, int data_c) {
+    ur_send_line("Angle(Degrees)   raw");
+
+    int i;
+    for (i = 0; i < data_c; i++) {
+        char buff[64];
+        sprintf(buff, "%-17d%d", i * SCAN_RESOLUTION, data[i]);
+        ur_send_line(buff);
+    }
+}
+
+
+
+// clean up a scan
+// the original multipass cleaner. compares window edges and clamps the middle values, order dependent
+static void sc_clean_scan_legacy(float * data, int data_c) {
+    int sweep_range = 4;
+    while (sweep_range >= 3) { // multipass,
+        int i;
+        for (i = 0; i < data_c - sweep_range; i++) {
+
+            float edge_far = data[i];
+            float edge_close = data[i + sweep_range - 1];
+
+            if (edge_far < edge_close) { // swap if close is further than far
+                float temp = edge_far;
+                edge_far = edge_close;
+                edge_close = temp;
+            }
+
+            int j;
+            for (j = 1; j < sweep_range - 1; j++) { // for each of the middle values, if they are too far out of range adjust them
+                if (data[i + j] > edge_far + 2) data[i + j] = edge_far;
+                if (data[i + j] < edge_close - 2) data[i + j] = edge_close;
+            }
+
+        }
+
+        sweep_range--;
+    }
+}
+
+
+
+// scratch for the windowed filters, they always read from an untouched copy so the result doesn't depend on order
+#define SC_FILTER_MAX_N 181
+static float sc_filter_src[SC_FILTER_MAX_N];
+static float sc_filter_lo[SC_FILTER_MAX_N];
+static float sc_filter_hi[SC_FILTER_MAX_N];
+static short sc_deque_lo[SC_FILTER_MAX_N];
+static short sc_deque_hi[SC_FILTER_MAX_N];
+
+// sorts window (tiny) and returns the middle
+static float sc_median_of(float * window, int n) {
+    int i, j;
+    for (i = 1; i < n; i++) {
+        const float v = window[i];
+        for (j = i; j > 0 && window[j - 1] > v; j--) window[j] = window[j - 1];
+        window[j] = v;
+    }
+    return (n & 1) ? window[n / 2] : (window[n / 2 - 1] + window[n / 2]) / 2;
+}
+
+// copies the median window around i out of sc_filter_src, clipped at the ends
+static int sc_gather_window(int i, int data_c, int half, float * window) {
+    const int from = i - half < 0 ? 0 : i - half;
+    const int to = i + half > data_c - 1 ? data_c - 1 : i + half;
+    int k;
+    for (k = from; k <= to; k++) window[k - from] = sc_filter_src[k];
+    return to - from + 1;
+}
+
+// running median of SC_MEDIAN_K samples
+static void sc_filter_median(float * data, int data_c) {
+    float window[SC_MEDIAN_K];
+    int i;
+    for (i = 0; i < data_c; i++) {
+        const int n = sc_gather_window(i, data_c, SC_MEDIAN_K / 2, window);
+        data[i] = sc_median_of(window, n);
+    }
+}
+
+// hampel, only samples more than SC_HAMPEL_T scaled mads from the window median are replaced by it
+static void sc_filter_hampel(float * data, int data_c) {
+    float window[SC_HAMPEL_K];
+    int i, k;
+    for (i = 0; i < data_c; i++) {
+        const int n = sc_gather_window(i, data_c, SC_HAMPEL_K / 2, window);
+        const float median = sc_median_of(window, n);
+
+        for (k = 0; k < n; k++) window[k] = fabsf(window[k] - median);
+        const float mad = 1.4826f * sc_median_of(window, n); // scaled to a std dev for gaussian noise
+
+        const float off = fabsf(sc_filter_src[i] - median);
+        if (off > SC_HAMPEL_T * mad && off > SC_HAMPEL_MIN_CM) data[i] = median;
+    }
+}
+
+// min and max of sc_filter_src over the SC_DESPIKE_W samples before each index (step 1) or after it (step -1)
+// monotonic deques, every index goes in and out once so it's linear no matter the window
+// with combine set, lo keeps the bigger of the two mins and hi the smaller of the two maxes instead of being overwritten
+static void sc_window_min_max(int data_c, int step, char combine, float * lo, float * hi) {
+    int lo_head = 0, lo_tail = 0;
+    int hi_head = 0, hi_tail = 0;
+
+    const int first = step > 0 ? 0 : data_c - 1;
+    int n;
+    for (n = 0; n < data_c; n++) {
+        const int i = first + n * step;
+
+        // drop what fell out of the window
+        while (lo_head < lo_tail && abs(i - sc_deque_lo[lo_head]) > SC_DESPIKE_W) lo_head++;
+        while (hi_head < hi_tail && abs(i - sc_deque_hi[hi_head]) > SC_DESPIKE_W) hi_head++;
+
+        // the window is empty at the very end, use the sample itself so it's left alone
+        const float window_lo = lo_head < lo_tail ? sc_filter_src[sc_deque_lo[lo_head]] : sc_filter_src[i];
+        const float window_hi = hi_head < hi_tail ? sc_filter_src[sc_deque_hi[hi_head]] : sc_filter_src[i];
+
+        if (combine) {
+            lo[i] = fmaxf(lo[i], window_lo);
+            hi[i] = fminf(hi[i], window_hi);
+        }
+        else {
+            lo[i] = window_lo;
+            hi[i] = window_hi;
+        }
+
+        // push i for the next index, anything it beats can never be the extreme again
+        const float v = sc_filter_src[i];
+        while (lo_head < lo_tail && sc_filter_src[sc_deque_lo[lo_tail - 1]] >= v) lo_tail--;
+        sc_deque_lo[lo_tail++] = i;
+        while (hi_head < hi_tail && sc_filter_src[sc_deque_hi[hi_tail - 1]] <= v) hi_tail--;
+        sc_deque_hi[hi_tail++] = i;
+    }
+}
+
+// linear version of the legacy cleaner. a sample is a spike if it clears something on both sides within SC_DESPIKE_W samples,
+// it gets clamped to the nearer side. edges between two flat levels are left alone, spikes up to SC_DESPIKE_W wide are removed
+static void sc_filter_despike(float * data, int data_c) {
+    sc_window_min_max(data_c, 1, 0, sc_filter_lo, sc_filter_hi);
+    sc_window_min_max(data_c, -1, 1, sc_filter_lo, sc_filter_hi);
+
+    int i;
+    for (i = 0; i < data_c; i++) {
+        if      (sc_filter_src[i] > sc_filter_lo[i] + SC_DESPIKE_TOLERANCE) data[i] = sc_filter_lo[i];
+        else if (sc_filter_src[i] < sc_filter_hi[i] - SC_DESPIKE_TOLERANCE) data[i] = sc_filter_hi[i];
+    }
+}
+
+// clean up a scan with the legacy cleaner
+void sc_clean_scan(float * data, int data_c) {
+    sc_clean_scan_with(data, data_c, SC_FILTER_LEGACY);
+}
+
+// clean up a scan with one of the SC_FILTER_ filters
+void sc_clean_scan_with(float * data, int data_c, char filter) {
+    if (filter == SC_FILTER_NONE) return;
+    if (filter == SC_FILTER_LEGACY) {
+        sc_clean_scan_legacy(data, data_c);
+        return;
+    }
+
+    if (data_c > SC_FILTER_MAX_N) {
+        ur_send_line("Warning: scan too long to filter, left as is");
+        return;
+    }
+    memcpy(sc_filter_src, data, data_c * sizeof(float));
+
+    if      (filter == SC_FILTER_MEDIAN)  sc_filter_median(data, data_c);
+    else if (filter == SC_FILTER_HAMPEL)  sc_filter_hampel(data, data_c);
+    else if (filter == SC_FILTER_DESPIKE) sc_filter_despike(data, data_c);
+}
+
+
+
+
+// pass the scan data (ideally after sc_clean_scan was called)
+// populates objects and objects_c, finding objects within the max distance
+// filters objects with a rad smaller than min_rad
+#define MARCH_EDGE_TOLERANCE 10
+
+
+
+// algorithm for processing raw ir data and adding them to object radial map objects
+void sc_find_objects(float * data, int data_c, float max_distance, int min_rad, object_radial * objects, int * objects_c) {
+    sc_find_objects_sector(data, data_c, max_distance, min_rad, 0, 180, objects, objects_c);
+}
+
+// sc_find_objects for a partial sweep, objects touching the window edges are ignored
+void sc_find_objects_sector(float * data, int data_c, float max_distance, int min_rad, int start_angle, int end_angle, object_radial * objects, int * objects_c) {
+    float march_min = data[0]; // we follow the line, allowing it to expand slowly for "diagonal" objects
+    float march_max = data[0];
+
+    int march_start = 0; // the start of the march in deg
+
+    int i;
+    for (i = 1; i < data_c; i++) {
+        if (data[i] > march_max + MARCH_EDGE_TOLERANCE || data[i] < march_min - MARCH_EDGE_TOLERANCE || i == data_c - 1) { // next step not within 5 units or end of scan, end march
+            int march_length = i - march_start;
+            float march_dist = (march_min + march_max) / 2; // innacurate, but good enough approx of object dist (for now)
+
+            if (
+                    march_length >= (min_rad / SCAN_RESOLUTION) && march_dist <= max_distance && // found an object within our constraints
+                    march_start > ((start_angle + 2) / SCAN_RESOLUTION) && (march_start + march_length) < ((end_angle - 2) / SCAN_RESOLUTION) // object isn't on the very edge of the scan
+            ) {
+                objects[*objects_c].angle = (march_start + (march_length / 2)) * SCAN_RESOLUTION + SWEEP_ANGLE_COMP;
+                objects[*objects_c].diameter = march_length * SCAN_RESOLUTION;
+                objects[*objects_c].distance = march_dist;
+                
+                (*objects_c)++;
+            }
+
+            if (i != data_c - 1) { // reset for new march
+                march_min = data[i+1];
+                march_max = data[i+1];
+                march_start = i;
+            }
+        } else {
+            if      (data[i] > march_max) march_max = data[i]; // expand the scope of the march
+            else if (data[i] < march_min) march_min = data[i];
+        }
+    }
+
+}
+
+// prints out the data from sc_find_objects
+void sc_print_objects(object_radial * objects, int objects_c) {
+    ur_send_line("Object  Angle  Distance  angluar  size");
+
+    int i;
+    for (i = 0; i < objects_c; i++) {
+        char buff[64];
+        sprintf(buff, "%-8d%-7d%-10.2f%-10d%.2f", i, objects[i].angle, objects[i].distance, objects[i].diameter, objects[i].size);
+        ur_send_line(buff);
+    }
+}
+
+
+
+// refinds the distances to objects with the ping sensor
+// the echo from one object is collected while the servo is already turning towards the next
+void sc_reping_objects(object_radial * objects, int objects_c) {
+    float dist;
+
+    int i;
+    for (i = 0; i <= objects_c; i++) {
+        if (i < objects_c) sv_start_angle(objects[i].angle);
+
+        // get accurate distance measurement of the last object. out of range keeps the ir distance
+        if (i > 0) {
+            while (!pb_ping_poll(&dist)) /* noop */ ;
+
+            if (dist != PING_OUT_OF_RANGE) objects[i - 1].distance = dist;
+
+            // make a silly sound
+            sound_beep();
+        }
+
+        if (i == objects_c) break;
+
+        sv_wait_settled();
+
+        pb_ping_start();
+    }
+}
+
+// sets the object distances from a fused sweep instead of re-pinging each one
+void sc_objects_distance_from_sweep(object_radial * objects, int objects_c, float * fused, int data_c) {
+    int i;
+    for (i = 0; i < objects_c; i++) {
+        int n = (objects[i].angle - SWEEP_ANGLE_COMP) / SCAN_RESOLUTION;
+        if (n < 0) n = 0;
+        if (n > data_c - 1) n = data_c - 1;
+
+        objects[i].distance = fused[n];
+    }
+}
+
+// populates the size property of the objects
+// requires the angular radius and distance to be accurate. it's recommended to use an ir sweep scan and then reping objects before calling this.
+void sc_calc_size_objects(object_radial * objects, int objects_c) {
+    int i;
+    for (i = 0; i < objects_c; i++) {
+
+        // update the object
+        objects[i].size = objects[i].distance * (objects[i].diameter * M_PI) / 180.0f; // rough approximation
+
+    }
+}
+
+
+
+// servo dynamics calibration. an ir reading only settles once the servo is in place and the sensor has caught up,
+// so timing that for a few move sizes and fitting a line gives the slew rate and fixed settle time the scans need
+#define SV_CAL_TOLERANCE 40 // adc counts a reading has to be within to count as in place
+#define SV_CAL_WINDOW_MS 1500 // how long each move is watched for
+
+// times a move from angle a to angle b. returns the ms until the ir reading settled, or -1 if the scene looks the same at a and b
+static int sc_time_servo_move(int a, int b) {
+    // learn what b looks like, then park at a
+    sv_set_angle(b);
+    timer_waitMillis(500);
+    const int at_b = ir_sample(IR_REDUCE_MEDIAN);
+
+    sv_set_angle(a);
+    timer_waitMillis(500);
+    const int at_a = ir_sample(IR_REDUCE_MEDIAN);
+
+    if (abs(at_a - at_b) < 3 * SV_CAL_TOLERANCE) return -1;
+
+    // watch the move, the last reading that wasn't b yet is when it arrived
+    const unsigned int start = timer_getMicros();
+    unsigned int last_off = 0;
+
+    sv_start_angle(b);
+    while (timer_getMicros() - start < SV_CAL_WINDOW_MS * 1000u) {
+        const int value = ir_sample(IR_REDUCE_MEDIAN);
+        if (abs(value - at_b) > SV_CAL_TOLERANCE) last_off = timer_getMicros() - start;
+    }
+
+    return (last_off + 999u) / 1000u;
+}
+
+// blocking, the bot should face a cluttered scene so the ir reading changes along the sweep
+void sc_cal_servo_dynamics() {
+    static const int move_sizes[] = {5, 10, 20, 45, 90, 135, 180};
+    const int move_count = sizeof(move_sizes) / sizeof(move_sizes[0]);
+
+    float sum_n = 0;
+    float sum_x = 0;  // degrees moved
+    float sum_y = 0;  // ms to settle
+    float sum_x2 = 0;
+    float sum_xy = 0;
+
+    char buff[64];
+
+    int i, start;
+    for (i = 0; i < move_count; i++) {
+        const int size = move_sizes[i];
+
+        // a few spots along the arc, both directions
+        for (start = 0; start + size <= 180; start += (180 - size > 0) ? (180 - size) / 2 : 180) {
+            int direction;
+            for (direction = 0; direction < 2; direction++) {
+                const int a = direction ? start + size : start;
+                const int b = direction ? start : start + size;
+
+                const int t = sc_time_servo_move(a, b);
+                if (t < 0) continue;
+
+                sprintf(buff, "servo move %d -> %d: %d ms", a, b, t);
+                ur_send_line(buff);
+
+                sum_n++;
+                sum_x += size;
+                sum_y += t;
+                sum_x2 += size * size;
+                sum_xy += size * t;
+            }
+        }
+    }
+
+    const float denom = sum_n * sum_x2 - sum_x * sum_x;
+    if (sum_n < 3 || denom == 0) {
+        ur_send_line("servo dynamics cal failed, not enough distinct readings. face something closer");
+        return;
+    }
+
+    const float ms_per_deg = (sum_n * sum_xy - sum_x * sum_y) / denom;
+    float settle_ms = (sum_y - ms_per_deg * sum_x) / sum_n;
+    if (settle_ms < 0) settle_ms = 0;
+
+    sv_set_dynamics_known(ms_per_deg, settle_ms);
+
+    sprintf(buff, "servo dynamics values - ms per deg: %.4f, settle ms: %.2f", ms_per_deg, settle_ms);
+    ur_send_line(buff);
+}
@@ -1,84 +1,160 @@
-#pragma once
-
-#define scan_point_data_t cyBOT_Scan_t
-#define servo_cal_data_t cyBOT_SERVRO_cal_t
-
-
-
-// SCAN RESOLUTION in deg
-#define SCAN_RESOLUTION 1
-
-// a compensation of n degrees (clockwise) due to scan sweep latency
-#define SWEEP_ANGLE_COMP (-3)
-
-
-
-typedef struct object_radial {
-    int angle; // the angle of the center of the object
-    int diameter; // the radial size of the object
-    float distance; // the distace to the edge of the object
-    float size; // the actual diameter of the object, in cm. need to call
-} object_radial;
-
-
-typedef struct object_positional {
-    float x; // x pos in mm
-    float y; // y pos in mm
-    float radius; // radius of the object in mm;
-    char type; // 0 is short object, 1 is tall object, 2 is hole (black), 3 is edge (white)
-} object_positional;
-
-
-// runs init
-void sc_init(int servo_enable, int ping_enable, int ir_enable);
-// runs init with all values set to 1
-void sc_init_all();
-
-
-
-// point the servo
-void sc_point_servo(int angle);
-
-// runs a scan, returns a scan_data
-void sc_sweep_sound(float * output);
-
-// scan a single point with ping. returns dist
-float sc_scan_sound(int angle);
-
-
-// sweep scan with ir sensor, 2 deg increment. populates int array of minimum length 91 with RAW VALUES.
-void sc_sweep_ir(float * output);
-
-// get an individual ir scan value, raw
-// angle input 0-180
-int sc_scan_ir(int angle);
-
-
-
-// pretty prints scan data to uart
-void sc_print_sweep(float * data, int data_c);
-// print sweep scan with int values, assumes 2 deg increment
-void sc_print_sweep_raw(int * data, int data_c);
-
-// clean up a scan
-void sc_clean_scan(float * data, int data_c);
-
-
-// pass the scan data (ideally after sc_clean_scan was called)
-// populates objects and objects_c, finding objects within the max distance
-// filters objects with a rad smaller than min_rad
-void sc_find_objects(float * data, int data_c, float max_distance, int min_rad, object_radial * objects, int * objects_c);
-
-// prints objects
-void sc_print_objects(object_radial * objects, int objects_c);
-
-
-
-
-// refinds the distances to objects with the ping sensor
-void sc_reping_objects(object_radial * objects, int objects_c);
-
-// populates the size property of the objects
-// requires the angular radius and distance to be accurate. it's recommended to use an ir sweep scan and then reping objects before calling this.
-void sc_calc_size_objects(object_radial * objects, int objects_c);
-
+#pragma once
+
+#define scan_point_data_t cyBOT_Scan_t
+#define servo_cal_data_t cyBOT_SERVRO_cal_t
+
+
+
+// SCAN RESOLUTION in deg
+#define SCAN_RESOLUTION 1
+
+// a compensation of n degrees (clockwise) due to scan sweep latency
+#define SWEEP_ANGLE_COMP (-3)
+
+// how ir sweeps reduce each burst of samples, see IR_REDUCE_ in ir.h
+#define SCAN_IR_REDUCE IR_REDUCE_MIN
+
+// fused sweeps ping on every n-th sample step
+#define SCAN_PING_EVERY 3
+
+// scan cleaning filters, see sc_clean_scan_with
+#define SC_FILTER_NONE 0
+#define SC_FILTER_LEGACY 1 // the original multipass edge clamp
+#define SC_FILTER_MEDIAN 2 // running median of SC_MEDIAN_K
+#define SC_FILTER_HAMPEL 3 // median of SC_HAMPEL_K, but only for samples that are outliers by mad
+#define SC_FILTER_DESPIKE 4 // linear time version of the legacy clamp
+
+#define SC_MEDIAN_K 5
+#define SC_HAMPEL_K 7
+#define SC_HAMPEL_T 3.0f // mads off the median before a sample is an outlier
+#define SC_HAMPEL_MIN_CM 2.0f // and never for less than this, flat stretches have a mad of ~0
+#define SC_DESPIKE_W 2 // widest spike removed, in samples
+#define SC_DESPIKE_TOLERANCE 2.0f // cm a spike has to clear its neighbours by
+
+// filter for each sensor's sweep
+#define SCAN_IR_FILTER SC_FILTER_DESPIKE
+#define SCAN_FUSED_FILTER SC_FILTER_HAMPEL
+
+// sensor fusion. the ping is about flat noise, the ir noise is from ir_cm_sigma
+#define FUSE_PING_SIGMA 1.0f // cm
+#define FUSE_GATE 3.0f // std devs of disagreement before the ping is thrown out
+
+
+
+typedef struct object_radial {
+    int angle; // the angle of the center of the object
+    int diameter; // the radial size of the object
+    float distance; // the distace to the edge of the object
+    float size; // the actual diameter of the object, in cm. need to call
+} object_radial;
+
+
+typedef struct object_positional {
+    float x; // x pos in mm
+    float y; // y pos in mm
+    float radius; // radius of the object in mm;
+    char type; // 0 is short object, 1 is tall object, 2 is hole (black), 3 is edge (white)
+    unsigned int last_seen; // timer_getMillis when it was last observed
+    unsigned char confidence; // how sure we are it's real, 0-255
+    unsigned short id; // stays the same for as long as the object is on the map, unlike its index. 0 is never used
+    float variance; // how uncertain the position is, mm^2 per axis
+
+    // evidence for what the object is, see object_classify in main_objects.h
+    unsigned char seen; // times a scan found it
+    unsigned char bumps; // times it was bumped into
+    unsigned char cliffs; // times the cliff sensors found it
+    unsigned char class_confidence; // how sure we are of the type, 0-255
+    unsigned char range_disagree; // running mean of how far apart the ir and ping ranges were, cm
+    unsigned short width_mean; // running mean of the scanned width, mm
+    unsigned short width_dev; // running mean of how far each scanned width was off width_mean, mm
+} object_positional;
+
+
+typedef struct wall_segment {
+    float ax, ay; // ends in mm. for the border, outside is on the right going from a to b
+    float bx, by;
+    char type; // 1 is a scanned wall, 3 is edge (white)
+    unsigned char support; // how many times it has been seen
+} wall_segment;
+
+
+// runs init
+void sc_init(int servo_enable, int ping_enable, int ir_enable);
+// runs init with all values set to 1
+void sc_init_all();
+
+
+
+// point the servo
+void sc_point_servo(int angle);
+
+// runs a scan, returns a scan_data
+void sc_sweep_sound(float * output);
+
+// scan a single point with ping. returns dist
+float sc_scan_sound(int angle);
+
+
+// sweep scan with ir sensor, 2 deg increment. populates int array of minimum length 91 with RAW VALUES.
+void sc_sweep_ir(float * output);
+
+// sweep scan with ir sensor over the servo window [start_angle, end_angle], stepping resolution degrees at a time
+// populates the same SCAN_RESOLUTION indexed buffer as sc_sweep_ir. angles skipped between steps hold the last sample, angles outside the window are not touched
+void sc_sweep_ir_sector(float * output, int start_angle, int end_angle, int resolution);
+
+// one pass sweep of the window with both sensors. ir_output is filled like sc_sweep_ir_sector. the ping fires with every
+// ping_every-th ir sample and fused_output gets the ir and ping distances fused per angle with sc_fuse_ranges
+// fused_output may be NULL for an ir only sweep
+void sc_sweep_fused_sector(float * ir_output, float * fused_output, int start_angle, int end_angle, int resolution, int ping_every);
+
+// fuses an ir and a ping distance (cm) for the same angle. the ping can be PING_OUT_OF_RANGE
+float sc_fuse_ranges(float ir_cm, float ping_cm);
+
+// get an individual ir scan value, raw
+// angle input 0-180
+int sc_scan_ir(int angle);
+
+
+
+// pretty prints scan data to uart
+void sc_print_sweep(float * data, int data_c);
+// print sweep scan with int values, assumes 2 deg increment
+void sc_print_sweep_raw(int * data, int data_c);
+
+// clean up a scan, with the legacy filter
+void sc_clean_scan(float * data, int data_c);
+
+// clean up a scan with one of the SC_FILTER_ filters. all but the legacy one are linear time and don't depend on
+// the order samples are visited in. scans longer than 181 samples are left as is
+void sc_clean_scan_with(float * data, int data_c, char filter);
+
+
+// pass the scan data (ideally after sc_clean_scan was called)
+// populates objects and objects_c, finding objects within the max distance
+// filters objects with a rad smaller than min_rad
+void sc_find_objects(float * data, int data_c, float max_distance, int min_rad, object_radial * objects, int * objects_c);
+
+// same as sc_find_objects, but for a scan of only the servo window [start_angle, end_angle]
+// objects cut off by the edge of the window are filtered the same way as objects on the edge of a full scan
+void sc_find_objects_sector(float * data, int data_c, float max_distance, int min_rad, int start_angle, int end_angle, object_radial * objects, int * objects_c);
+
+// prints objects
+void sc_print_objects(object_radial * objects, int objects_c);
+
+
+
+
+// refinds the distances to objects with the ping sensor
+void sc_reping_objects(object_radial * objects, int objects_c);
+
+// sets the object distances from the fused output of sc_sweep_fused_sector, does the job of sc_reping_objects without moving the servo again
+void sc_objects_distance_from_sweep(object_radial * objects, int objects_c, float * fused, int data_c);
+
+// populates the size property of the objects
+// requires the angular radius and distance to be accurate. it's recommended to use an ir sweep scan and then reping objects before calling this.
+void sc_calc_size_objects(object_radial * objects, int objects_c);
+
+
+// blocking servo dynamics calibration, times servo moves with the ir sensor and sets the result with sv_set_dynamics_known
+// the bot should be facing a cluttered scene. prints the values to store with the other cal values
+void sc_cal_servo_dynamics();
@@ -1,125 +1,190 @@
-#include "Timer.h"
-#include "button.h"
-#include "lcd.h"
-
-#include <stdint.h>
-#include <math.h>
-#include <inc/tm4c123gh6pm.h>
-
-#include "servo.h"
-
-
-
-#define SERVO_PERIOD_TICKS       (320000u)                 // 20 ms * 16 MHz
-#define SERVO_LOAD_24            (SERVO_PERIOD_TICKS - 1u) // 319,999 = 0x04E1FF
-
-static volatile uint32_t g_servo_high_ticks = 24000; // default value is ~50%
-
-void sv_init() {
-    SYSCTL_RCGCGPIO_R |= 0x02; // clock timer 1
-    SYSCTL_RCGCTIMER_R |= 0x02; // click GPIO PB
-    timer_waitMillis(1);
-
-    // GPIO: PB5 as T1CCP1
-    GPIO_PORTB_AFSEL_R |= (1 << 5); // AF
-    GPIO_PORTB_DEN_R   |= (1 << 5); // DEN
-    // PCTL: set PB5 nibble to 0x7 (T1CCP1)
-    GPIO_PORTB_PCTL_R = (GPIO_PORTB_PCTL_R & ~((0xF) << (5 * 4))) | ((0b0111) << (5 * 4));
-
-    // Timer1B PWM @ 20 ms, non-inverted, down count
-    TIMER1_CTL_R  &= ~(1u << 8); // EN B = 0
-    TIMER1_CFG_R   = 0x4;        // split mode
-
-    /* TBMR:
-       - TnMR=0b10 (periodic)
-       - TnAMS=1 (PWM mode)
-       - TnCDIR=0 (down)
-       - TnMRSU=1 (bit10): update MATCH on next cycle (glitchless updates) */
-    TIMER1_TBMR_R  = 0;
-    TIMER1_TBMR_R |= 0x2u;       // periodic
-    TIMER1_TBMR_R |= (1u << 3);  // AMS=1 -> PWM
-    TIMER1_TBMR_R &= ~(1u << 4); // down-count
-    TIMER1_TBMR_R |= (1u << 10); // MRSU: match updates take effect at rollover
-
-    // Non-inverted PWM output: TBPWML=0 (output set at reload, cleared at match)
-    TIMER1_CTL_R  &= ~(1u << 14);
-
-    // Period = 0x04E1FF -> TBPR=0x04, TBILR=0xE1FF
-    TIMER1_TBPR_R  = (uint8_t)((SERVO_LOAD_24 >> 16) & 0xFFu);
-    TIMER1_TBILR_R = (uint16_t)(SERVO_LOAD_24 & 0xFFFFu);
-
-    // Initial high-time = 1.5 ms -> 24,000 ticks -> MATCH = LOAD - H
-    uint32_t match_init = SERVO_LOAD_24 - g_servo_high_ticks;
-    TIMER1_TBPMR_R   = (uint8_t)((match_init >> 16) & 0xFF);
-    TIMER1_TBMATCHR_R= (uint16_t)(match_init & 0xFFFF);
-
-    TIMER1_CTL_R  |= (1u << 8); // TBEN=1 */
-}
-
-
-
-/* Sets the PWM HIGH width in raw clock cycles (ticks).
-   Example: 1.5 ms -> 0.0015 * 16e6 = 24000 ticks. */
-void sv_set_width(uint32_t width_ticks)
-{
-    if (width_ticks > SERVO_LOAD_24) {
-        width_ticks = SERVO_LOAD_24;
-    } else if (width_ticks == 0) {
-        width_ticks = 1;
-    }
-
-    g_servo_high_ticks = width_ticks;
-
-    uint32_t match = SERVO_LOAD_24 - g_servo_high_ticks;
-    TIMER1_TBPMR_R    = (uint8_t)((match >> 16) & 0xFF);
-    TIMER1_TBMATCHR_R = (uint16_t)(match & 0xFFFF);
-}
-
-
-
-
-
-// calibration stuff
-static uint32_t SERVO_MIN_VALUE = 12000;
-static uint32_t SERVO_MAX_VALUE = 36000;
-
-void sv_set_cal_known(uint32_t min_val, uint32_t max_val) {
-    SERVO_MIN_VALUE = min_val;
-    SERVO_MAX_VALUE = max_val;
-}
-
-void sv_set_angle(int angle) {
-    const int new_servo_value = SERVO_MIN_VALUE + roundf( (angle / 180.0f) * (SERVO_MAX_VALUE - SERVO_MIN_VALUE) );
-    unsigned int wait_time = (abs(new_servo_value - g_servo_high_ticks) * 900u) / (SERVO_MAX_VALUE - SERVO_MIN_VALUE); // rotation speed of about n milli seconds per 180 deg
-
-    sv_set_width(new_servo_value);
-    timer_waitMillis(wait_time);
-}
-
-// blocking calibration function call
-void sv_cal() {
-    button_init();
-    lcd_printf("b1: left - b2: rightb4: exit\nraw val: %d", g_servo_high_ticks);
-
-    while(1) {
-        if (button_getButtons() & 0b1000) break; // break condition
-
-        char new_print = 0;
-
-        if (button_getButtons() & 0b0001) {
-            sv_set_width(g_servo_high_ticks + 150);
-            new_print = 1;
-        }
-        if (button_getButtons() & 0b0010) {
-            sv_set_width(g_servo_high_ticks - 150);
-            new_print = 1;
-        }
-
-        if (new_print) {
-            lcd_printf("b1: left - b2: rightb4: exit\nraw val: %d", g_servo_high_ticks);
-            timer_waitMillis(10);
-        }
-    }
-
-}
-
+#include "Timer.h"
+#include "button.h"
+#include "lcd.h"
+
+#include <stdint.h>
+#include <math.h>
+#include <inc/tm4c123gh6pm.h>
+
+#include "servo.h"
+
+
+
+#define SERVO_PERIOD_TICKS       (320000u)                 // 20 ms * 16 MHz
+#define SERVO_LOAD_24            (SERVO_PERIOD_TICKS - 1u) // 319,999 = 0x04E1FF
+
+static volatile uint32_t g_servo_high_ticks = 24000; // default value is ~50%
+
+void sv_init() {
+    SYSCTL_RCGCGPIO_R |= 0x02; // clock timer 1
+    SYSCTL_RCGCTIMER_R |= 0x02; // click GPIO PB
+    timer_waitMillis(1);
+
+    // GPIO: PB5 as T1CCP1
+    GPIO_PORTB_AFSEL_R |= (1 << 5); // AF
+    GPIO_PORTB_DEN_R   |= (1 << 5); // DEN
+    // PCTL: set PB5 nibble to 0x7 (T1CCP1)
+    GPIO_PORTB_PCTL_R = (GPIO_PORTB_PCTL_R & ~((0xF) << (5 * 4))) | ((0b0111) << (5 * 4));
+
+    // Timer1B PWM @ 20 ms, non-inverted, down count
+    TIMER1_CTL_R  &= ~(1u << 8); // EN B = 0
+    TIMER1_CFG_R   = 0x4;        // split mode
+
+    /* TBMR:
+       - TnMR=0b10 (periodic)
+       - TnAMS=1 (PWM mode)
+       - TnCDIR=0 (down)
+       - TnMRSU=1 (bit10): update MATCH on next cycle (glitchless updates) */
+    TIMER1_TBMR_R  = 0;
+    TIMER1_TBMR_R |= 0x2u;       // periodic
+    TIMER1_TBMR_R |= (1u << 3);  // AMS=1 -> PWM
+    TIMER1_TBMR_R &= ~(1u << 4); // down-count
+    TIMER1_TBMR_R |= (1u << 10); // MRSU: match updates take effect at rollover
+
+    // Non-inverted PWM output: TBPWML=0 (output set at reload, cleared at match)
+    TIMER1_CTL_R  &= ~(1u << 14);
+
+    // Period = 0x04E1FF -> TBPR=0x04, TBILR=0xE1FF
+    TIMER1_TBPR_R  = (uint8_t)((SERVO_LOAD_24 >> 16) & 0xFFu);
+    TIMER1_TBILR_R = (uint16_t)(SERVO_LOAD_24 & 0xFFFFu);
+
+    // Initial high-time = 1.5 ms -> 24,000 ticks -> MATCH = LOAD - H
+    uint32_t match_init = SERVO_LOAD_24 - g_servo_high_ticks;
+    TIMER1_TBPMR_R   = (uint8_t)((match_init >> 16) & 0xFF);
+    TIMER1_TBMATCHR_R= (uint16_t)(match_init & 0xFFFF);
+
+    TIMER1_CTL_R  |= (1u << 8); // TBEN=1 */
+}
+
+
+
+/* Sets the PWM HIGH width in raw clock cycles (ticks).
+   Example: 1.5 ms -> 0.0015 * 16e6 = 24000 ticks. */
+void sv_set_width(uint32_t width_ticks)
+{
+    if (width_ticks > SERVO_LOAD_24) {
+        width_ticks = SERVO_LOAD_24;
+    } else if (width_ticks == 0) {
+        width_ticks = 1;
+    }
+
+    g_servo_high_ticks = width_ticks;
+
+    uint32_t match = SERVO_LOAD_24 - g_servo_high_ticks;
+    TIMER1_TBPMR_R    = (uint8_t)((match >> 16) & 0xFF);
+    TIMER1_TBMATCHR_R = (uint16_t)(match & 0xFFFF);
+}
+
+
+
+
+
+// calibration stuff
+static uint32_t SERVO_MIN_VALUE = 12000;
+static uint32_t SERVO_MAX_VALUE = 36000;
+
+void sv_set_cal_known(uint32_t min_val, uint32_t max_val) {
+    SERVO_MIN_VALUE = min_val;
+    SERVO_MAX_VALUE = max_val;
+}
+
+void sv_get_cal(uint32_t * min_val, uint32_t * max_val) {
+    *min_val = SERVO_MIN_VALUE;
+    *max_val = SERVO_MAX_VALUE;
+}
+
+// dynamics model, time to be in place = settle + slew per degree moved. defaults match the old 900 ms per 180 deg
+static float SERVO_MS_PER_DEG = 5.0f;
+static float SERVO_SETTLE_MS = 0.0f;
+
+void sv_set_dynamics_known(float ms_per_deg, float settle_ms) {
+    SERVO_MS_PER_DEG = ms_per_deg;
+    SERVO_SETTLE_MS = settle_ms;
+}
+
+void sv_get_dynamics(float * ms_per_deg, float * settle_ms) {
+    *ms_per_deg = SERVO_MS_PER_DEG;
+    *settle_ms = SERVO_SETTLE_MS;
+}
+
+static int g_servo_angle = 90; // last commanded angle
+static float g_servo_from = 90; // where the servo was when the last move started
+static unsigned int g_servo_move_start = 0; // timer_getMicros of the last move
+static unsigned int g_servo_move_time = 0; // predicted us for the last move
+
+// where the servo is predicted to be now. it slews at SERVO_MS_PER_DEG from g_servo_from, the settle time is spent at the end
+static float sv_position_now() {
+    const float moved = SERVO_MS_PER_DEG > 0 ? (timer_getMicros() - g_servo_move_start) / (1000.0f * SERVO_MS_PER_DEG) : 180;
+    const float left = g_servo_angle - g_servo_from;
+
+    if (moved >= fabsf(left)) return g_servo_angle;
+    return g_servo_from + (left > 0 ? moved : -moved);
+}
+
+unsigned int sv_estimate_settle(int angle) {
+    const float degrees = fabsf(angle - sv_position_now());
+
+    // already there, maybe still settling
+    if (degrees < 0.5f) return angle == g_servo_angle ? (sv_settle_remaining_us() + 999u) / 1000u : 0;
+    return roundf(SERVO_SETTLE_MS + degrees * SERVO_MS_PER_DEG);
+}
+
+unsigned int sv_start_angle(int angle) {
+    if (angle == g_servo_angle) return (sv_settle_remaining_us() + 999u) / 1000u; // already headed there
+
+    const int new_servo_value = SERVO_MIN_VALUE + roundf( (angle / 180.0f) * (SERVO_MAX_VALUE - SERVO_MIN_VALUE) );
+
+    // a move that interrupts another one starts from wherever the servo got to, not from either target
+    const unsigned int wait_time = sv_estimate_settle(angle);
+    g_servo_from = sv_position_now();
+
+    sv_set_width(new_servo_value);
+
+    g_servo_angle = angle;
+    g_servo_move_start = timer_getMicros();
+    g_servo_move_time = wait_time * 1000u;
+    return wait_time;
+}
+
+unsigned int sv_settle_remaining_us() {
+    const unsigned int elapsed = timer_getMicros() - g_servo_move_start;
+    if (elapsed >= g_servo_move_time) return 0;
+    return g_servo_move_time - elapsed;
+}
+
+void sv_wait_settled() {
+    while (sv_settle_remaining_us() > 0) /* noop */ ;
+}
+
+void sv_set_angle(int angle) {
+    sv_start_angle(angle);
+    sv_wait_settled();
+}
+
+// blocking calibration function call
+void sv_cal() {
+    button_init();
+    lcd_printf("b1: left - b2: rightb4: exit\nraw val: %d", g_servo_high_ticks);
+
+    while(1) {
+        if (button_getButtons() & 0b1000) break; // break condition
+
+        char new_print = 0;
+
+        if (button_getButtons() & 0b0001) {
+            sv_set_width(g_servo_high_ticks + 150);
+            new_print = 1;
+        }
+        if (button_getButtons() & 0b0010) {
+            sv_set_width(g_servo_high_ticks - 150);
+            new_print = 1;
+        }
+
+        if (new_print) {
+            lcd_printf("b1: left - b2: rightb4: exit\nraw val: %d", g_servo_high_ticks);
+            timer_waitMillis(10);
+        }
+    }
+
+}
+
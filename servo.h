@@ -1,16 +1,37 @@
-#pragma once
-
-// init the servo, starts the pwm timer immediately
-void sv_init();
-
-// set the high width of the wave in ticks. 16000 per ms.
-void sv_set_width(uint32_t width_ticks);
-
-// sets the servo angle, blocking delay included until servo is predicted to be in place
-void sv_set_angle(int angle);
-
-// blocking calibration routine, see lcd for instructions
-void sv_cal();
-
-// set the calibration values directly
-void sv_set_cal_known(uint32_t min_val, uint32_t max_val);
+#pragma once
+
+// init the servo, starts the pwm timer immediately
+void sv_init();
+
+// set the high width of the wave in ticks. 16000 per ms.
+void sv_set_width(uint32_t width_ticks);
+
+// sets the servo angle, blocking delay included until servo is predicted to be in place
+void sv_set_angle(int angle);
+
+// sets the servo angle without waiting, returns the ms until the servo is predicted to be in place
+unsigned int sv_start_angle(int angle);
+
+// us left until the last sv_start_angle is predicted to be in place, 0 once it is
+unsigned int sv_settle_remaining_us();
+
+// blocks until the last sv_start_angle is predicted to be in place
+void sv_wait_settled();
+
+// predicted ms for a move from the current angle to angle, from the dynamics model
+unsigned int sv_estimate_settle(int angle);
+
+// set the dynamics model directly, time to be in place = settle_ms + ms_per_deg * degrees moved. see sc_cal_servo_dynamics
+void sv_set_dynamics_known(float ms_per_deg, float settle_ms);
+
+// get the dynamics model in use
+void sv_get_dynamics(float * ms_per_deg, float * settle_ms);
+
+// blocking calibration routine, see lcd for instructions
+void sv_cal();
+
+// set the calibration values directly
+void sv_set_cal_known(uint32_t min_val, uint32_t max_val);
+
+// get the calibration values in use
+void sv_get_cal(uint32_t * min_val, uint32_t * max_val);
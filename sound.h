@@ -1,15 +1,15 @@
-#pragma once
-
-#include "open_interface.h"
-
-// Initialize songs, called once at start
-void sound_init();
-
-// Play a short beep
-void sound_beep();
-
-// Play a startup sound
-void sound_startup();
-
-// Play a success sound
-void sound_success();
+#pragma once
+
+#include "open_interface.h"
+
+// Initialize songs, called once at start
+void sound_init();
+
+// Play a short beep
+void sound_beep();
+
+// Play a startup sound
+void sound_startup();
+
+// Play a success sound
+void sound_success();
@@ -0,0 +1,3 @@
+#pragma once
+
+// host stand in for the driverlib header, nothing the tests build uses it
@@ -0,0 +1,3 @@
+#pragma once
+
+// host stand in for the device header, the code the tests build doesn't touch any registers
@@ -0,0 +1,51 @@
+// the hardware calls scan.c and the main_*.h headers make, as do nothing host versions. the code under test never reaches
+// most of them. the pose is whatever the test sets in stub_pos_x/y/r
+
+#include <stdio.h>
+#include <stdint.h>
+#include <math.h>
+#include <time.h>
+
+#include "uart.h"
+#include "ir.h"
+#include "ping.h"
+#include "servo.h"
+#include "scan.h"
+
+void ur_send_line(char * line) { printf("[uart] %s\n", line); }
+
+unsigned int timer_getMicros() { return clock() * (1000000.0 / CLOCKS_PER_SEC); }
+unsigned int timer_getMillis() { return timer_getMicros() / 1000; }
+void timer_waitMillis(unsigned int ms) { (void) ms; }
+
+int ir_sample(char mode) { (void) mode; return 0; }
+int ir_floor_sample() { return 0; }
+float ir_raw_to_cm(int raw) { return raw; }
+float ir_cm_sigma(float cm) { return 0.5f + 0.02f * cm; }
+void ir_burst_start() {}
+char ir_burst_ready() { return 1; }
+int ir_burst_reduce(char mode) { (void) mode; return 0; }
+
+void pb_ping_start() {}
+char pb_ping_poll(float * cm) { *cm = 0; return 1; }
+float pb_get_dist() { return 0; }
+
+void sv_set_angle(int angle) { (void) angle; }
+unsigned int sv_start_angle(int angle) { (void) angle; return 0; }
+void sv_wait_settled() {}
+void sv_set_dynamics_known(float ms_per_deg, float settle_ms) { (void) ms_per_deg; (void) settle_ms; }
+
+void sound_beep() {}
+
+float stub_pos_x = 0, stub_pos_y = 0, stub_pos_r = 0;
+float get_pos_x() { return stub_pos_x; }
+float get_pos_y() { return stub_pos_y; }
+float get_pos_r() { return stub_pos_r; }
+float dist2(float ax, float ay, float bx, float by) { return (ax - bx) * (ax - bx) + (ay - by) * (ay - by); }
+float dist(float ax, float ay, float bx, float by) { return sqrtf(dist2(ax, ay, bx, by)); }
+
+void send_data_packet(object_positional * object_map, int object_map_c, char do_objects) {
+    (void) object_map;
+    (void) object_map_c;
+    (void) do_objects;
+}
@@ -0,0 +1,240 @@
+// checks is_point_free and segment_clear in main_pathfinding.h against testing every object and wall exactly, on random
+// maps and bot positions, then times both
+//
+// the planning snapshot and the spatial index only ever rule objects out, so the answers have to match the brute force
+// ones exactly. some objects and a wall are put right next to the bot every map, so the brushing case (the tolerance is
+// dropped, see is_object_brushing_bot) is always hit
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include "scan.h"
+#include "movement.h"
+#include "Timer.h"
+
+// in stub_hw.c, main.c gets these from the bot and data_protocol.h
+extern float stub_pos_x, stub_pos_y, stub_pos_r;
+void send_data_packet(object_positional * object_map, int object_map_c, char do_objects);
+
+#include "main_scan_data.h"
+#include "main_objects.h"
+#include "main_pathfinding.h"
+#include "main_grid_planner.h"
+
+#define MAPS 40
+#define QUERIES 2000
+#define FIELD_HALF_MM 2500
+
+
+
+// ------------------------------ references ------------------------------
+// every object and wall, with the inflated radii worked out on the spot. the occupancy grid is checked the same way as in
+// main_pathfinding.h (it's empty here) so the times compare like for like
+
+static char ref_wall_blocks_point(int index, float px, float py) {
+    const wall_segment *s = &segment_map[index];
+    const float r = segment_inflated_radius_now(index);
+    if (point_segment_dist2(px, py, s->ax, s->ay, s->bx, s->by) <= r * r) return 1;
+
+    if (s->type == 3) {
+        const float dx = s->bx - s->ax;
+        const float dy = s->by - s->ay;
+        const float t = (px - s->ax) * dx + (py - s->ay) * dy;
+        const float side = (px - s->ax) * dy - (py - s->ay) * dx;
+        if (side > 0 && t >= 0 && t <= dx * dx + dy * dy) return 1;
+    }
+    return 0;
+}
+
+static char ref_point_free(float px, float py) {
+#if OCC_PLANNING
+    if (occ_point_blocked(px, py)) return 0;
+#endif
+
+    int i;
+    for (i = 0; i < segment_map_c; i++) {
+        if (ref_wall_blocks_point(i, px, py)) return 0;
+    }
+    for (i = 0; i < object_map_c; i++) {
+        const float r = object_inflated_radius_now(i);
+        if (dist2(px, py, object_map[i].x, object_map[i].y) <= r * r) return 0;
+    }
+    return 1;
+}
+
+static char ref_segment_clear(float ax, float ay, float bx, float by) {
+    const float dx = bx - ax;
+    const float dy = by - ay;
+    if (dx == 0 && dy == 0) return ref_point_free(ax, ay);
+
+#if OCC_PLANNING
+    if (occ_segment_blocked(ax, ay, bx, by)) return 0;
+#endif
+
+    int i;
+    for (i = 0; i < segment_map_c; i++) {
+        const wall_segment *s = &segment_map[i];
+        const float r = segment_inflated_radius_now(i);
+        if (ref_wall_blocks_point(i, ax, ay) || ref_wall_blocks_point(i, bx, by)) return 0;
+
+        const float d1 = (s->bx - s->ax) * (ay - s->ay) - (s->by - s->ay) * (ax - s->ax);
+        const float d2 = (s->bx - s->ax) * (by - s->ay) - (s->by - s->ay) * (bx - s->ax);
+        const float d3 = (bx - ax) * (s->ay - ay) - (by - ay) * (s->ax - ax);
+        const float d4 = (bx - ax) * (s->by - ay) - (by - ay) * (s->bx - ax);
+        if (((d1 > 0) != (d2 > 0)) && ((d3 > 0) != (d4 > 0))) return 0;
+
+        if (point_segment_dist2(s->ax, s->ay, ax, ay, bx, by) <= r * r) return 0;
+        if (point_segment_dist2(s->bx, s->by, ax, ay, bx, by) <= r * r) return 0;
+    }
+
+    const float inv_len2 = 1.0f / (dx * dx + dy * dy);
+    for (i = 0; i < object_map_c; i++) {
+        const float r = object_inflated_radius_now(i);
+        if (plan_segment_dist2(ax - object_map[i].x, ay - object_map[i].y, dx, dy, inv_len2) <= r * r) return 0;
+    }
+    return 1;
+}
+
+
+
+// ------------------------------ maps ------------------------------
+
+static float uniform(float lo, float hi) {
+    return lo + (hi - lo) * (rand() / (float) RAND_MAX);
+}
+
+static double seconds() {
+    return clock() / (double) CLOCKS_PER_SEC;
+}
+
+typedef struct query {
+    float ax, ay, bx, by;
+} query;
+
+static query queries[QUERIES];
+
+// count objects anywhere on the field, two of them and a wall up against the bot, and the far edge of the field as border
+// (outside is on the right going a to b, so it runs right to left)
+static void build_map(int count) {
+    object_map_c = 0;
+    segment_map_c = 0;
+    object_map_version++;
+    segment_map_version++;
+
+    stub_pos_x = uniform(-1000, 1000);
+    stub_pos_y = uniform(-1000, 1000);
+
+    int i;
+    for (i = 0; i < count; i++) {
+        float x = uniform(-FIELD_HALF_MM, FIELD_HALF_MM), y = uniform(-FIELD_HALF_MM, FIELD_HALF_MM);
+        if (i < 2) {
+            const float a = uniform(0, 2 * M_PI);
+            const float d = uniform(BOT_RADIUS, BOT_RADIUS + 2 * CLEARANCE_TOLERANCE);
+            x = stub_pos_x + d * cosf(a);
+            y = stub_pos_y + d * sinf(a);
+        }
+        add_object_to_map(x, y, uniform(30, 200), (char) (rand() % 3), 128);
+    }
+
+    const float a = uniform(0, 2 * M_PI);
+    const float d = uniform(BOT_RADIUS, BOT_RADIUS + 2 * CLEARANCE_TOLERANCE);
+    const float wx = stub_pos_x + d * cosf(a), wy = stub_pos_y + d * sinf(a);
+    segment_map[segment_map_c++] = (wall_segment) { .ax = wx - 400 * sinf(a), .ay = wy + 400 * cosf(a), .bx = wx + 400 * sinf(a), .by = wy - 400 * cosf(a), .type = 1 };
+    segment_map[segment_map_c++] = (wall_segment) { .ax = FIELD_HALF_MM, .ay = FIELD_HALF_MM, .bx = -FIELD_HALF_MM, .by = FIELD_HALF_MM, .type = 3 };
+
+    for (i = 0; i < QUERIES; i++) {
+        query *q = &queries[i];
+        q->ax = uniform(-FIELD_HALF_MM, FIELD_HALF_MM);
+        q->ay = uniform(-FIELD_HALF_MM, FIELD_HALF_MM);
+        q->bx = q->ax + uniform(-2000, 2000);
+        q->by = q->ay + uniform(-2000, 2000);
+    }
+}
+
+typedef struct result {
+    int bad;
+    int blocked;
+    double us, ref_us;
+} result;
+
+// the answers against the reference, then the time per query of each (the map is already built, so the snapshot and
+// index are only rebuilt on the first query, like they are for a real plan)
+static void run(char segments, result * r) {
+    int i;
+    for (i = 0; i < QUERIES; i++) {
+        const query *q = &queries[i];
+        const char got = segments ? segment_clear(q->ax, q->ay, q->bx, q->by) : is_point_free(q->ax, q->ay);
+        const char want = segments ? ref_segment_clear(q->ax, q->ay, q->bx, q->by) : ref_point_free(q->ax, q->ay);
+        if (got != want) {
+            if (r->bad < 5) {
+                if (segments) printf("  segment (%.0f, %.0f)-(%.0f, %.0f): got %d, want %d\n", q->ax, q->ay, q->bx, q->by, got, want);
+                else printf("  point (%.0f, %.0f): got %d, want %d\n", q->ax, q->ay, got, want);
+            }
+            r->bad++;
+        }
+        r->blocked += !want;
+    }
+
+    const int reps = 20;
+    volatile int sink = 0;
+    int k;
+
+    double start = seconds();
+    for (k = 0; k < reps; k++) {
+        for (i = 0; i < QUERIES; i++) {
+            const query *q = &queries[i];
+            sink += segments ? segment_clear(q->ax, q->ay, q->bx, q->by) : is_point_free(q->ax, q->ay);
+        }
+    }
+    r->us += (seconds() - start) * 1e6 / (reps * QUERIES);
+
+    start = seconds();
+    for (k = 0; k < reps; k++) {
+        for (i = 0; i < QUERIES; i++) {
+            const query *q = &queries[i];
+            sink += segments ? ref_segment_clear(q->ax, q->ay, q->bx, q->by) : ref_point_free(q->ax, q->ay);
+        }
+    }
+    r->ref_us += (seconds() - start) * 1e6 / (reps * QUERIES);
+}
+
+int main() {
+    srand(288);
+    const int counts[] = { 4, 16, 64 };
+
+    int failed = 0;
+    printf("%-8s %-9s %-8s %10s %10s %8s\n", "objects", "query", "vs ref", "ns", "ref ns", "blocked");
+
+    int c;
+    for (c = 0; c < 3; c++) {
+        result point = { 0 }, segment = { 0 };
+
+        int m;
+        for (m = 0; m < MAPS; m++) {
+            build_map(counts[c]);
+            run(0, &point);
+            run(1, &segment);
+        }
+
+        const result *results[] = { &point, &segment };
+        const char *names[] = { "point", "segment" };
+        int k;
+        for (k = 0; k < 2; k++) {
+            const result *r = results[k];
+            failed += r->bad;
+            printf("%-8d %-9s %-8s %10.1f %10.1f %7.0f%%\n", counts[c], names[k], r->bad ? "BAD" : "exact",
+                   r->us * 1000 / MAPS, r->ref_us * 1000 / MAPS, 100.0 * r->blocked / (MAPS * QUERIES));
+        }
+    }
+
+    if (failed) {
+        printf("\nFAILED, %d answers differ from the reference\n", failed);
+        return 1;
+    }
+    printf("\nok\n");
+    return 0;
+}
@@ -0,0 +1,298 @@
+// checks the word parallel tile ops of the exploration heat map in main_pathfinding.h against doing each 4 bit lane on its
+// own, and exp_map_region_min against looking at every cell in the box, then times both
+//
+// the tiles are random words plus a map built from a random walk, so every lane value and tile edge gets hit
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include "scan.h"
+#include "movement.h"
+#include "Timer.h"
+
+// in stub_hw.c, main.c gets these from the bot and data_protocol.h
+extern float stub_pos_x, stub_pos_y, stub_pos_r;
+void send_data_packet(object_positional * object_map, int object_map_c, char do_objects);
+
+#include "main_scan_data.h"
+#include "main_objects.h"
+#include "main_pathfinding.h"
+#include "main_grid_planner.h"
+
+#define LANES (EXP_TILE_CELLS * EXP_TILE_CELLS)
+#define WORDS 20000
+#define BOXES 2000
+
+static uint64_t words[WORDS];
+
+
+
+// ------------------------------ references ------------------------------
+// one lane at a time, straight from the comments on the swar ops
+
+static unsigned int lane(uint64_t x, int i) {
+    return (x >> (4 * i)) & 0xF;
+}
+
+static uint64_t with_lane(uint64_t x, int i, unsigned int v) {
+    return (x & ~(((uint64_t) 0xF) << (4 * i))) | (((uint64_t) v) << (4 * i));
+}
+
+static uint64_t ref_nonzero(uint64_t x) {
+    uint64_t out = 0;
+    int i;
+    for (i = 0; i < LANES; i++) out = with_lane(out, i, lane(x, i) != 0);
+    return out;
+}
+
+static uint64_t ref_full(uint64_t x) {
+    uint64_t out = 0;
+    int i;
+    for (i = 0; i < LANES; i++) out = with_lane(out, i, lane(x, i) == 15);
+    return out;
+}
+
+static uint64_t ref_eq(uint64_t x, unsigned int v) {
+    uint64_t out = 0;
+    int i;
+    for (i = 0; i < LANES; i++) out = with_lane(out, i, lane(x, i) == v);
+    return out;
+}
+
+static uint64_t ref_dec(uint64_t x) {
+    int i;
+    for (i = 0; i < LANES; i++) if (lane(x, i)) x = with_lane(x, i, lane(x, i) - 1);
+    return x;
+}
+
+static uint64_t ref_inc(uint64_t x, uint64_t lanes) {
+    int i;
+    for (i = 0; i < LANES; i++) if (lane(lanes, i) && lane(x, i) < 15) x = with_lane(x, i, lane(x, i) + 1);
+    return x;
+}
+
+static unsigned int ref_min(uint64_t x) {
+    unsigned int m = 15;
+    int i;
+    for (i = 0; i < LANES; i++) if (lane(x, i) < m) m = lane(x, i);
+    return m;
+}
+
+static int ref_first_lane(uint64_t lanes) {
+    int i;
+    for (i = 0; i < LANES; i++) if (lane(lanes, i)) return i;
+    return -1;
+}
+
+// the weight of every cell with its center in the box, as the comment on exp_map_region_min says: the fine cell if its tile
+// is stored, otherwise the coarse cell at the tile's first cell in the box. returns the lowest, 0 for an empty box
+static unsigned int ref_region_min(float x0, float y0, float x1, float y1) {
+    const int cx0 = ceilf(x0 / EXP_MAP_SPACING), cx1 = floorf(x1 / EXP_MAP_SPACING);
+    const int cy0 = ceilf(y0 / EXP_MAP_SPACING), cy1 = floorf(y1 / EXP_MAP_SPACING);
+    if (cx0 > cx1 || cy0 > cy1) return 0;
+
+    unsigned int best = 16;
+    int cx, cy;
+    for (cy = cy0; cy <= cy1; cy++) {
+        for (cx = cx0; cx <= cx1; cx++) {
+            const int tx = exp_floor_div(cx), ty = exp_floor_div(cy);
+            const exp_tile * t = exp_tile_find(&exp_fine, tx, ty);
+
+            unsigned int value;
+            if (t) value = exp_tile_val_at(t, cx - tx * EXP_TILE_CELLS, cy - ty * EXP_TILE_CELLS);
+            else {
+                const int fx = MAX(cx0, tx * EXP_TILE_CELLS), fy = MAX(cy0, ty * EXP_TILE_CELLS);
+                const int coarse = exp_level_val(&exp_coarse, fx * EXP_MAP_SPACING, fy * EXP_MAP_SPACING);
+                value = coarse != -1 ? coarse : 0;
+            }
+            if (value < best) best = value;
+        }
+    }
+    return best;
+}
+
+
+
+// ------------------------------ checks ------------------------------
+
+static double seconds() {
+    return clock() / (double) CLOCKS_PER_SEC;
+}
+
+static float uniform(float lo, float hi) {
+    return lo + (hi - lo) * (rand() / (float) RAND_MAX);
+}
+
+// random lanes, skewed so that runs of 0 and 15 (where the carries go wrong) come up often
+static uint64_t random_tile() {
+    uint64_t x = 0;
+    int i;
+    for (i = 0; i < LANES; i++) {
+        const int r = rand() % 4;
+        x = with_lane(x, i, r == 0 ? 0 : r == 1 ? 15 : rand() % 16);
+    }
+    return x;
+}
+
+static int check_ops() {
+    int bad = 0;
+    int i;
+    for (i = 0; i < WORDS; i++) {
+        const uint64_t x = words[i];
+        const uint64_t lanes = ref_nonzero(words[(i + 1) % WORDS]);
+        const unsigned int v = rand() % 16;
+
+        bad += exp_swar_nonzero(x) != ref_nonzero(x);
+        bad += exp_swar_full(x) != ref_full(x);
+        bad += exp_swar_eq(x, v) != ref_eq(x, v);
+        bad += exp_swar_dec(x) != ref_dec(x);
+        bad += exp_swar_inc(x, lanes) != ref_inc(x, lanes);
+        bad += exp_swar_min(x) != ref_min(x);
+        if (lanes) bad += exp_swar_first_lane(lanes) != ref_first_lane(lanes);
+    }
+    return bad;
+}
+
+// a walk around a pen about the size of the test field, big enough for the fine table to drop tiles so the coarse fallback
+// gets used too
+#define PEN_HALF_MM 3500
+
+static void build_map() {
+    exp_map_clear();
+    float x = 0, y = 0, heading = 0;
+    int i;
+    for (i = 0; i < 6000; i++) {
+        heading += uniform(-0.6f, 0.6f);
+        x += 150 * cosf(heading);
+        y += 150 * sinf(heading);
+        if (fabsf(x) > PEN_HALF_MM || fabsf(y) > PEN_HALF_MM) {
+            x = fmaxf(-PEN_HALF_MM, fminf(PEN_HALF_MM, x));
+            y = fmaxf(-PEN_HALF_MM, fminf(PEN_HALF_MM, y));
+            heading += M_PI;
+        }
+        stub_pos_x = x;
+        stub_pos_y = y;
+        exp_map_new_searched_point(x, y);
+    }
+}
+
+static void random_box(float * x0, float * y0, float * x1, float * y1, float half) {
+    const float cx = stub_pos_x + uniform(-GLOBAL_HALF_SIZE_MM, GLOBAL_HALF_SIZE_MM);
+    const float cy = stub_pos_y + uniform(-GLOBAL_HALF_SIZE_MM, GLOBAL_HALF_SIZE_MM);
+    *x0 = cx - uniform(0, half);
+    *x1 = cx + uniform(0, half);
+    *y0 = cy - uniform(0, half);
+    *y1 = cy + uniform(0, half);
+}
+
+// the value has to match, and the cell it points at has to be in the box and have that value
+static int check_region(float half) {
+    int bad = 0;
+    int i;
+    for (i = 0; i < BOXES; i++) {
+        float x0, y0, x1, y1, ox, oy;
+        random_box(&x0, &y0, &x1, &y1, half);
+
+        const unsigned int got = exp_map_region_min(x0, y0, x1, y1, &ox, &oy);
+        const unsigned int want = ref_region_min(x0, y0, x1, y1);
+        if (got != want) {
+            if (bad < 5) printf("  region (%.0f, %.0f)-(%.0f, %.0f): got %u, want %u\n", x0, y0, x1, y1, got, want);
+            bad++;
+            continue;
+        }
+
+        if (ox < x0 - 1 || ox > x1 + 1 || oy < y0 - 1 || oy > y1 + 1) {
+            if (bad < 5) printf("  region (%.0f, %.0f)-(%.0f, %.0f): cell (%.0f, %.0f) is outside it\n", x0, y0, x1, y1, ox, oy);
+            bad++;
+        }
+    }
+    return bad;
+}
+
+// nanoseconds per call, the swar version and then the lane by lane one
+static void bench_ops(double * ns, double * ref_ns) {
+    const int reps = 50;
+    volatile uint64_t sink = 0;
+    int r, i;
+
+    double start = seconds();
+    for (r = 0; r < reps; r++) {
+        for (i = 0; i < WORDS; i++) sink += exp_swar_dec(words[i]) + exp_swar_min(words[i]) + exp_swar_eq(words[i], r & 15);
+    }
+    *ns = (seconds() - start) * 1e9 / (reps * WORDS);
+
+    start = seconds();
+    for (r = 0; r < reps; r++) {
+        for (i = 0; i < WORDS; i++) sink += ref_dec(words[i]) + ref_min(words[i]) + ref_eq(words[i], r & 15);
+    }
+    *ref_ns = (seconds() - start) * 1e9 / (reps * WORDS);
+}
+
+static void bench_region(float half, double * us, double * ref_us) {
+    float box[BOXES][4];
+    volatile unsigned int sink = 0;
+    int i;
+
+    srand(42);
+    for (i = 0; i < BOXES; i++) random_box(&box[i][0], &box[i][1], &box[i][2], &box[i][3], half);
+
+    double start = seconds();
+    for (i = 0; i < BOXES; i++) {
+        float ox, oy;
+        sink += exp_map_region_min(box[i][0], box[i][1], box[i][2], box[i][3], &ox, &oy);
+    }
+    *us = (seconds() - start) * 1e6 / BOXES;
+
+    start = seconds();
+    for (i = 0; i < BOXES; i++) sink += ref_region_min(box[i][0], box[i][1], box[i][2], box[i][3]);
+    *ref_us = (seconds() - start) * 1e6 / BOXES;
+}
+
+int main() {
+    srand(288);
+    int i;
+    for (i = 0; i < WORDS; i++) words[i] = random_tile();
+    build_map();
+    printf("map: %d fine tiles, %d coarse tiles\n", exp_fine.count, exp_coarse.count);
+
+    int failed = 0;
+
+    double ns, ref_ns;
+    const int ops_bad = check_ops();
+    bench_ops(&ns, &ref_ns);
+    failed += ops_bad;
+    printf("\n%-22s %-8s %12s %12s\n", "", "vs ref", "time", "ref time");
+    printf("%-22s %-8s %9.2f ns %9.2f ns\n", "tile ops", ops_bad ? "BAD" : "exact", ns, ref_ns);
+
+    // the box exp_map_pick_random_point refines in, and one as big as the area it samples
+    const float halves[] = { SAMPLE_REFINE_HALF_MM, GLOBAL_HALF_SIZE_MM };
+    const char * names[] = { "region, refine box", "region, sample area" };
+    for (i = 0; i < 2; i++) {
+        double us, ref_us;
+        const int bad = check_region(halves[i]);
+        bench_region(halves[i], &us, &ref_us);
+        failed += bad;
+        printf("%-22s %-8s %9.2f us %9.2f us\n", names[i], bad ? "BAD" : "exact", us, ref_us);
+    }
+
+    // the picker itself on the same map, which must only pick free points
+    int picked_bad = 0;
+    for (i = 0; i < 200; i++) {
+        float px, py;
+        exp_map_pick_random_point(&px, &py);
+        picked_bad += !is_point_free(px, py);
+    }
+    failed += picked_bad;
+    printf("%-22s %s\n", "picked points", picked_bad ? "BAD" : "free");
+
+    if (failed) {
+        printf("\nFAILED, %d results differ from the reference\n", failed);
+        return 1;
+    }
+    printf("\nok\n");
+    return 0;
+}
@@ -0,0 +1,340 @@
+// checks the scan cleaning filters in scan.c against plain brute force versions, then times them and counts how many
+// objects sc_find_objects gets right after each one
+//
+// sweeps come from the files on the command line, in the format sc_print_sweep sends (a uart log works, lines that
+// aren't "angle value" are skipped, and an "[rx] " prefix from pysocket is fine). with no files it uses a fixed set of
+// generated sweeps: a few objects in front of a far background, with the ir noise of ir_cm_sigma plus 1 and 2 sample
+// spikes and dropouts. only generated sweeps know where the objects are, so the object counts are only printed for them
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include "scan.h"
+
+#define SCAN_BUFFER_SIZE (180 / SCAN_RESOLUTION + 1) // as in main_scan_data.h
+#define SCAN_MAX_DISTANCE 70
+#define N SCAN_BUFFER_SIZE
+#define MAX_SWEEPS 256
+#define MAX_TRUTH 8
+
+typedef struct sweep {
+    float data[N];
+    int truth_c; // -1 when it was loaded from a file
+    int truth_angle[MAX_TRUTH];
+} sweep;
+
+static sweep sweeps[MAX_SWEEPS];
+static int sweeps_c = 0;
+
+
+
+// ------------------------------ references ------------------------------
+// the obvious way to do each filter, straight from the comments in scan.c
+
+static int cmp_float(const void * a, const void * b) {
+    const float x = *(const float *) a, y = *(const float *) b;
+    return (x > y) - (x < y);
+}
+
+static float median_sorted(float * v, int n) {
+    qsort(v, n, sizeof(float), cmp_float);
+    return (n & 1) ? v[n / 2] : (v[n / 2 - 1] + v[n / 2]) / 2;
+}
+
+// the window of 2 * half + 1 around i, clipped at the ends
+static int window(const float * src, int i, int half, float * out) {
+    int n = 0, k;
+    for (k = i - half; k <= i + half; k++) {
+        if (k >= 0 && k < N) out[n++] = src[k];
+    }
+    return n;
+}
+
+static void ref_median(const float * src, float * out) {
+    float w[SC_MEDIAN_K];
+    int i;
+    for (i = 0; i < N; i++) out[i] = median_sorted(w, window(src, i, SC_MEDIAN_K / 2, w));
+}
+
+static void ref_hampel(const float * src, float * out) {
+    float w[SC_HAMPEL_K];
+    int i, k;
+    for (i = 0; i < N; i++) {
+        const int n = window(src, i, SC_HAMPEL_K / 2, w);
+        const float median = median_sorted(w, n);
+        for (k = 0; k < n; k++) w[k] = fabsf(w[k] - median);
+        const float mad = 1.4826f * median_sorted(w, n);
+
+        const float off = fabsf(src[i] - median);
+        out[i] = (off > SC_HAMPEL_T * mad && off > SC_HAMPEL_MIN_CM) ? median : src[i];
+    }
+}
+
+// a sample is clamped if it clears the SC_DESPIKE_W samples on both sides of it. lo is the bigger of the two side mins and
+// hi the smaller of the two side maxes, a side with nothing in it (at the ends) is the sample itself
+static void ref_despike(const float * src, float * out) {
+    int i, k;
+    for (i = 0; i < N; i++) {
+        float lo = -INFINITY, hi = INFINITY;
+        int side;
+        for (side = -1; side <= 1; side += 2) {
+            float side_lo = INFINITY, side_hi = -INFINITY;
+            for (k = 1; k <= SC_DESPIKE_W; k++) {
+                const int j = i + side * k;
+                if (j < 0 || j >= N) continue;
+                side_lo = fminf(side_lo, src[j]);
+                side_hi = fmaxf(side_hi, src[j]);
+            }
+            if (side_lo == INFINITY) side_lo = side_hi = src[i];
+            lo = fmaxf(lo, side_lo);
+            hi = fminf(hi, side_hi);
+        }
+
+        if      (src[i] > lo + SC_DESPIKE_TOLERANCE) out[i] = lo;
+        else if (src[i] < hi - SC_DESPIKE_TOLERANCE) out[i] = hi;
+        else                                          out[i] = src[i];
+    }
+}
+
+
+
+// ------------------------------ sweeps ------------------------------
+
+static float gaussian() {
+    const float u = (rand() + 1.0f) / (RAND_MAX + 2.0f);
+    const float v = (rand() + 1.0f) / (RAND_MAX + 2.0f);
+    return sqrtf(-2 * logf(u)) * cosf(2 * M_PI * v);
+}
+
+static float uniform(float lo, float hi) {
+    return lo + (hi - lo) * (rand() / (float) RAND_MAX);
+}
+
+// a few round objects (cm) in front of a far background, sampled like a real sweep
+static void generate(sweep * s) {
+    float obj_angle[MAX_TRUTH], obj_half[MAX_TRUTH], obj_dist[MAX_TRUTH];
+    const int count = 1 + rand() % 4;
+    const float background = uniform(90, 160);
+
+    s->truth_c = 0;
+    int k, i;
+    for (k = 0; k < count; k++) {
+        const float d = uniform(20, 60);
+        const float r = uniform(3, 8);
+        const float a = uniform(20, 160);
+
+        // keep them apart so each one is its own run of samples
+        char clear = 1;
+        for (i = 0; i < s->truth_c; i++) clear &= fabsf(obj_angle[i] - a) > 25;
+        if (!clear) continue;
+
+        obj_angle[s->truth_c] = a;
+        obj_half[s->truth_c] = atanf(r / d) * 180 / M_PI;
+        obj_dist[s->truth_c] = d;
+        s->truth_angle[s->truth_c] = roundf(a);
+        s->truth_c++;
+    }
+
+    for (i = 0; i < N; i++) {
+        const float angle = i * SCAN_RESOLUTION;
+        float d = background;
+        for (k = 0; k < s->truth_c; k++) {
+            if (fabsf(angle - obj_angle[k]) <= obj_half[k]) d = fminf(d, obj_dist[k]);
+        }
+        s->data[i] = d + gaussian() * (0.5f + 0.02f * d); // same shape as ir_cm_sigma
+    }
+
+    // spikes up to SC_DESPIKE_W wide, both ways, and the odd dropout to the far end of the range
+    const int spikes = rand() % 6;
+    for (k = 0; k < spikes; k++) {
+        const int at = rand() % N;
+        const int width = 1 + rand() % SC_DESPIKE_W;
+        const float jump = (rand() & 1 ? 1 : -1) * uniform(15, 40);
+        for (i = at; i < at + width && i < N; i++) s->data[i] = fmaxf(5, s->data[i] + jump);
+    }
+    if (rand() % 4 == 0) s->data[rand() % N] = 250;
+}
+
+// reads every sweep in a sc_print_sweep log, returns how many
+static int load(const char * path) {
+    FILE * f = fopen(path, "r");
+    if (!f) {
+        fprintf(stderr, "can't open %s\n", path);
+        exit(2);
+    }
+
+    char line[256];
+    int found = 0;
+    int filled = 0;
+    while (fgets(line, sizeof(line), f) && sweeps_c < MAX_SWEEPS) {
+        const char * p = line;
+        if (strncmp(p, "[rx] ", 5) == 0) p += 5;
+
+        int angle;
+        float value;
+        if (sscanf(p, "%d %f", &angle, &value) != 2 || angle < 0 || angle > 180 || angle % SCAN_RESOLUTION) continue;
+
+        sweep * s = &sweeps[sweeps_c];
+        if (angle == 0) filled = 0;
+        s->data[angle / SCAN_RESOLUTION] = value;
+        filled++;
+
+        if (angle == 180 && filled == N) {
+            s->truth_c = -1;
+            sweeps_c++;
+            found++;
+        }
+    }
+
+    fclose(f);
+    return found;
+}
+
+
+
+// ------------------------------ checks ------------------------------
+
+typedef struct filter_case {
+    const char * name;
+    char filter;
+    void (*ref)(const float *, float *);
+} filter_case;
+
+static const filter_case cases[] = {
+    { "none",    SC_FILTER_NONE,    NULL },
+    { "legacy",  SC_FILTER_LEGACY,  NULL },
+    { "median",  SC_FILTER_MEDIAN,  ref_median },
+    { "hampel",  SC_FILTER_HAMPEL,  ref_hampel },
+    { "despike", SC_FILTER_DESPIKE, ref_despike },
+};
+#define CASES ((int) (sizeof(cases) / sizeof(cases[0])))
+
+static double seconds() {
+    return clock() / (double) CLOCKS_PER_SEC;
+}
+
+// the filter against its reference on every sweep, bit for bit. returns the number of sweeps that differ
+static int check(const filter_case * c) {
+    int bad = 0;
+    int i, k;
+    for (i = 0; i < sweeps_c; i++) {
+        float got[N], want[N];
+        memcpy(got, sweeps[i].data, sizeof(got));
+        sc_clean_scan_with(got, N, c->filter);
+        c->ref(sweeps[i].data, want);
+
+        for (k = 0; k < N; k++) {
+            if (got[k] != want[k]) {
+                if (bad < 5) printf("  %s differs on sweep %d at %d: got %.3f, want %.3f\n", c->name, i, k * SCAN_RESOLUTION, got[k], want[k]);
+                bad++;
+                break;
+            }
+        }
+    }
+    return bad;
+}
+
+// microseconds per sweep, the filter in scan.c and then the reference
+static void bench(const filter_case * c, double * us, double * ref_us) {
+    const int reps = 200;
+    float work[N];
+    int r, i;
+
+    double start = seconds();
+    for (r = 0; r < reps; r++) {
+        for (i = 0; i < sweeps_c; i++) {
+            memcpy(work, sweeps[i].data, sizeof(work));
+            sc_clean_scan_with(work, N, c->filter);
+        }
+    }
+    *us = (seconds() - start) * 1e6 / (reps * sweeps_c);
+
+    *ref_us = 0;
+    if (!c->ref) return;
+    start = seconds();
+    for (r = 0; r < reps; r++) {
+        for (i = 0; i < sweeps_c; i++) c->ref(sweeps[i].data, work);
+    }
+    *ref_us = (seconds() - start) * 1e6 / (reps * sweeps_c);
+}
+
+// objects found after the filter on the generated sweeps, as hits (within a few degrees of a real one) and false ones
+static void detect(const filter_case * c, int * hits, int * truth, int * extra) {
+    *hits = *truth = *extra = 0;
+
+    int i, k, j;
+    for (i = 0; i < sweeps_c; i++) {
+        const sweep * s = &sweeps[i];
+        if (s->truth_c < 0) continue;
+
+        float work[N];
+        memcpy(work, s->data, sizeof(work));
+        sc_clean_scan_with(work, N, c->filter);
+
+        object_radial found[64];
+        int found_c = 0;
+        sc_find_objects(work, N, SCAN_MAX_DISTANCE, 4, found, &found_c);
+
+        char used[64] = {0};
+        int sweep_hits = 0;
+        for (k = 0; k < s->truth_c; k++) {
+            for (j = 0; j < found_c; j++) {
+                if (!used[j] && abs(found[j].angle - SWEEP_ANGLE_COMP - s->truth_angle[k]) <= 4) {
+                    used[j] = 1;
+                    sweep_hits++;
+                    break;
+                }
+            }
+        }
+        *hits += sweep_hits;
+        *truth += s->truth_c;
+        *extra += found_c - sweep_hits;
+    }
+}
+
+int main(int argc, char ** argv) {
+    int i;
+    for (i = 1; i < argc; i++) printf("%s: %d sweeps\n", argv[i], load(argv[i]));
+
+    if (sweeps_c == 0) {
+        srand(288);
+        while (sweeps_c < 200) generate(&sweeps[sweeps_c++]);
+        printf("%d generated sweeps\n", sweeps_c);
+    }
+
+    int failed = 0;
+    printf("\n%-8s %-10s %12s %12s %10s %8s\n", "filter", "vs ref", "us/sweep", "ref us", "objects", "false");
+    for (i = 0; i < CASES; i++) {
+        const filter_case * c = &cases[i];
+
+        const int bad = c->ref ? check(c) : 0;
+        failed += bad;
+
+        double us, ref_us;
+        bench(c, &us, &ref_us);
+
+        int hits, truth, extra;
+        detect(c, &hits, &truth, &extra);
+
+        char result[16];
+        if (!c->ref) strcpy(result, "-");
+        else if (bad) sprintf(result, "%d BAD", bad);
+        else strcpy(result, "exact");
+
+        printf("%-8s %-10s %12.2f ", c->name, result, us);
+        if (c->ref) printf("%12.2f ", ref_us);
+        else printf("%12s ", "-");
+        if (truth) printf("%5d/%-4d %8d\n", hits, truth, extra);
+        else printf("%10s %8s\n", "-", "-");
+    }
+
+    if (failed) {
+        printf("\nFAILED, %d sweeps differ from the reference\n", failed);
+        return 1;
+    }
+    printf("\nok\n");
+    return 0;
+}